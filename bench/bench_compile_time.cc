@@ -0,0 +1,59 @@
+#include <static_ptr/static_ptr.hpp>
+#include <utility>
+
+// instantiates handles, conversions between handle sizes and the type-erased
+// operations for a number of independent class hierarchies, to measure the
+// compile time of the template machinery per hierarchy. the number of
+// hierarchies is set with -DHIERARCHIES=N; the bench_compile_time_N targets
+// time the compilation for several N
+
+#ifndef HIERARCHIES
+#define HIERARCHIES 16
+#endif
+
+template <int I>
+struct base {
+  int value = I;
+  virtual ~base() {}
+  virtual int get() const { return value; }
+};
+template <int I>
+struct derived : base<I> {
+  int extra = I;
+  int get() const override { return this->value + extra; }
+};
+template <int I>
+struct more_derived : derived<I> {
+  long more = I;
+  int get() const override { return static_cast<int>(this->extra + more); }
+};
+
+template <int I>
+static int use()
+{
+  using small_ptr = static_ptr::static_ptr<base<I>, sizeof(derived<I>)>;
+  using large_ptr = static_ptr::static_ptr<base<I>, sizeof(more_derived<I>)>;
+  auto a = small_ptr::template make<derived<I>>();
+  small_ptr b{a};
+  b = std::move(a);
+  large_ptr c{b};
+  c = std::move(b);
+  large_ptr d{static_ptr::in_place_t<more_derived<I>>{}};
+  swap(c, d);
+  d = c;
+  return c->get() + d->get();
+}
+
+template <int ...Is>
+static int use_all(std::integer_sequence<int, Is...>)
+{
+  int sum = 0;
+  const int results[] = {(sum += use<Is>())...};
+  (void)results;
+  return sum;
+}
+
+int main()
+{
+  return use_all(std::make_integer_sequence<int, HIERARCHIES>{}) ? 0 : 1;
+}
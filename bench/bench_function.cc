@@ -0,0 +1,100 @@
+#include <static_ptr/static_function.hpp>
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <vector>
+
+// compare static_function against std::function, with a small capture that
+// fits in std::function's own small buffer and a large one that doesn't
+
+struct small_capture {
+  int a = 1;
+  int operator()(int i) const { return i + a; }
+};
+struct large_capture {
+  int a[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  int operator()(int i) const { return i + a[i & 7]; }
+};
+
+using std_function = std::function<int(int)>;
+using static_function = static_ptr::static_function<int(int),
+                                                    sizeof(large_capture)>;
+
+template <typename Function, typename Callable>
+static void BM_Construct(benchmark::State& state)
+{
+  for (auto _ : state) {
+    Function f{Callable{}};
+    benchmark::DoNotOptimize(f);
+  }
+}
+
+template <typename Function, typename Callable>
+static void BM_Call(benchmark::State& state)
+{
+  Function f{Callable{}};
+  int i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f);
+    benchmark::DoNotOptimize(i = f(i));
+  }
+}
+
+template <typename Function, typename Callable>
+static void BM_Copy(benchmark::State& state)
+{
+  const Function f{Callable{}};
+  for (auto _ : state) {
+    Function g{f};
+    benchmark::DoNotOptimize(g);
+  }
+}
+
+template <typename Function, typename Callable>
+static void BM_Move(benchmark::State& state)
+{
+  Function f{Callable{}};
+  for (auto _ : state) {
+    Function g{std::move(f)};
+    benchmark::DoNotOptimize(g);
+    f = std::move(g);
+    benchmark::DoNotOptimize(f);
+  }
+}
+
+// call each of a vector of callbacks
+template <typename Function>
+static void BM_CallbackList(benchmark::State& state)
+{
+  std::vector<Function> callbacks;
+  for (int i = 0; i < state.range(0); i++) {
+    if (i % 2) {
+      callbacks.emplace_back(small_capture{});
+    } else {
+      callbacks.emplace_back(large_capture{});
+    }
+  }
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& f : callbacks) {
+      sum += f(sum);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define FUNCTION_BENCHMARK(bm) \
+  BENCHMARK_TEMPLATE(bm, std_function, small_capture); \
+  BENCHMARK_TEMPLATE(bm, static_function, small_capture); \
+  BENCHMARK_TEMPLATE(bm, std_function, large_capture); \
+  BENCHMARK_TEMPLATE(bm, static_function, large_capture)
+
+FUNCTION_BENCHMARK(BM_Construct);
+FUNCTION_BENCHMARK(BM_Call);
+FUNCTION_BENCHMARK(BM_Copy);
+FUNCTION_BENCHMARK(BM_Move);
+
+BENCHMARK_TEMPLATE(BM_CallbackList, std_function)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_CallbackList, static_function)->Range(64, 64 << 10);
+
+BENCHMARK_MAIN();
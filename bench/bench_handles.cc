@@ -0,0 +1,217 @@
+#include <static_ptr/static_ptr.hpp>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <variant>
+#include <vector>
+
+// compare static_ptr against other ways of holding a polymorphic value:
+// std::unique_ptr, std::variant, and a value wrapper around a virtual clone()
+
+// static_ptr enables operations based on the base type and requires derived
+// types to support them too, so this is copyable and default constructible
+struct shape {
+  virtual ~shape() = default;
+  virtual int area() const { return 0; }
+  virtual std::unique_ptr<shape> clone() const {
+    return std::unique_ptr<shape>{new shape(*this)};
+  }
+};
+
+struct square final : shape {
+  int side = 0;
+  square() = default;
+  explicit square(int side) : side(side) {}
+  int area() const override { return side * side; }
+  std::unique_ptr<shape> clone() const override {
+    return std::unique_ptr<shape>{new square(*this)};
+  }
+};
+
+struct rectangle final : shape {
+  int width = 0;
+  int height = 0;
+  rectangle() = default;
+  rectangle(int width, int height) : width(width), height(height) {}
+  explicit rectangle(int side) : rectangle(side, side + 1) {}
+  int area() const override { return width * height; }
+  std::unique_ptr<shape> clone() const override {
+    return std::unique_ptr<shape>{new rectangle(*this)};
+  }
+};
+
+/// value-semantic handle that copies through shape::clone()
+class clone_ptr {
+  std::unique_ptr<shape> p;
+ public:
+  clone_ptr() = default;
+  explicit clone_ptr(std::unique_ptr<shape> p) : p(std::move(p)) {}
+  clone_ptr(clone_ptr&&) = default;
+  clone_ptr& operator=(clone_ptr&&) = default;
+  clone_ptr(const clone_ptr& o) : p(o.p ? o.p->clone() : nullptr) {}
+  clone_ptr& operator=(const clone_ptr& o) {
+    p = o.p ? o.p->clone() : nullptr;
+    return *this;
+  }
+  void reset() { p.reset(); }
+  const shape* operator->() const { return p.get(); }
+};
+
+// each handle kind provides the same static interface for the benchmarks
+
+struct static_ptr_kind {
+  using handle = static_ptr::static_ptr<shape, sizeof(rectangle)>;
+  template <typename U>
+  static handle make(int v) { return handle::make<U>(v); }
+  static void reset(handle& h) { h.reset(); }
+  static int area(const handle& h) { return h->area(); }
+};
+
+struct unique_ptr_kind {
+  using handle = std::unique_ptr<shape>;
+  template <typename U>
+  static handle make(int v) { return handle{new U(v)}; }
+  static void reset(handle& h) { h.reset(); }
+  static int area(const handle& h) { return h->area(); }
+};
+
+struct variant_kind {
+  using handle = std::variant<std::monostate, square, rectangle>;
+  template <typename U>
+  static handle make(int v) { return handle{std::in_place_type<U>, v}; }
+  static void reset(handle& h) { h = std::monostate{}; }
+  static int area(const handle& h) {
+    struct visitor {
+      int operator()(std::monostate) const { return 0; }
+      int operator()(const shape& s) const { return s.area(); }
+    };
+    return std::visit(visitor{}, h);
+  }
+};
+
+struct clone_kind {
+  using handle = clone_ptr;
+  template <typename U>
+  static handle make(int v) { return handle{std::unique_ptr<shape>{new U(v)}}; }
+  static void reset(handle& h) { h.reset(); }
+  static int area(const handle& h) { return h->area(); }
+};
+
+template <typename Kind>
+static void BM_Construct(benchmark::State& state)
+{
+  int v = 0;
+  for (auto _ : state) {
+    auto h = Kind::template make<rectangle>(++v);
+    benchmark::DoNotOptimize(h);
+  }
+}
+
+template <typename Kind>
+static void BM_Move(benchmark::State& state)
+{
+  auto a = Kind::template make<rectangle>(1);
+  for (auto _ : state) {
+    auto b = std::move(a);
+    benchmark::DoNotOptimize(b);
+    a = std::move(b);
+    benchmark::DoNotOptimize(a);
+  }
+}
+
+template <typename Kind>
+static void BM_Copy(benchmark::State& state)
+{
+  const auto a = Kind::template make<rectangle>(1);
+  for (auto _ : state) {
+    auto b = a;
+    benchmark::DoNotOptimize(b);
+  }
+}
+
+// assignment that alternates between different dynamic types
+template <typename Kind>
+static void BM_AssignAcrossTypes(benchmark::State& state)
+{
+  const auto s = Kind::template make<square>(1);
+  const auto r = Kind::template make<rectangle>(2);
+  auto h = s;
+  for (auto _ : state) {
+    h = r;
+    benchmark::DoNotOptimize(h);
+    h = s;
+    benchmark::DoNotOptimize(h);
+  }
+}
+
+template <typename Kind>
+static void BM_Reset(benchmark::State& state)
+{
+  for (auto _ : state) {
+    auto h = Kind::template make<rectangle>(1);
+    Kind::reset(h);
+    benchmark::DoNotOptimize(h);
+  }
+}
+
+// virtual call through operator-> or std::visit
+template <typename Kind>
+static void BM_Dispatch(benchmark::State& state)
+{
+  auto h = Kind::template make<rectangle>(3);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(h);
+    benchmark::DoNotOptimize(Kind::area(h));
+  }
+}
+
+// sum over a vector of mixed dynamic types
+template <typename Kind>
+static void BM_Iterate(benchmark::State& state)
+{
+  std::vector<typename Kind::handle> v;
+  v.reserve(state.range(0));
+  for (int i = 0; i < state.range(0); i++) {
+    if (i % 2) {
+      v.push_back(Kind::template make<square>(i));
+    } else {
+      v.push_back(Kind::template make<rectangle>(i));
+    }
+  }
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& h : v) {
+      sum += Kind::area(h);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define HANDLE_BENCHMARK(bm) \
+  BENCHMARK_TEMPLATE(bm, static_ptr_kind); \
+  BENCHMARK_TEMPLATE(bm, unique_ptr_kind); \
+  BENCHMARK_TEMPLATE(bm, variant_kind); \
+  BENCHMARK_TEMPLATE(bm, clone_kind)
+
+HANDLE_BENCHMARK(BM_Construct);
+HANDLE_BENCHMARK(BM_Reset);
+HANDLE_BENCHMARK(BM_Dispatch);
+
+// std::unique_ptr can't be copied
+BENCHMARK_TEMPLATE(BM_Move, static_ptr_kind);
+BENCHMARK_TEMPLATE(BM_Move, unique_ptr_kind);
+BENCHMARK_TEMPLATE(BM_Move, variant_kind);
+BENCHMARK_TEMPLATE(BM_Move, clone_kind);
+BENCHMARK_TEMPLATE(BM_Copy, static_ptr_kind);
+BENCHMARK_TEMPLATE(BM_Copy, variant_kind);
+BENCHMARK_TEMPLATE(BM_Copy, clone_kind);
+BENCHMARK_TEMPLATE(BM_AssignAcrossTypes, static_ptr_kind);
+BENCHMARK_TEMPLATE(BM_AssignAcrossTypes, variant_kind);
+BENCHMARK_TEMPLATE(BM_AssignAcrossTypes, clone_kind);
+
+BENCHMARK_TEMPLATE(BM_Iterate, static_ptr_kind)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_Iterate, unique_ptr_kind)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_Iterate, variant_kind)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_Iterate, clone_kind)->Range(64, 64 << 10);
+
+BENCHMARK_MAIN();
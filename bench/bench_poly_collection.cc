@@ -0,0 +1,92 @@
+#include <static_ptr/poly_collection.hpp>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// compare iteration over interleaved dynamic types in a vector of static_ptr
+// with the type-segregated loops of poly_collection
+
+struct shape {
+  virtual ~shape() = default;
+  virtual int area() const { return 0; }
+};
+struct square final : shape {
+  int side = 0;
+  square() = default;
+  explicit square(int side) : side(side) {}
+  int area() const override { return side * side; }
+};
+struct rectangle final : shape {
+  int width = 0;
+  int height = 0;
+  rectangle() = default;
+  explicit rectangle(int side) : width(side), height(side + 1) {}
+  int area() const override { return width * height; }
+};
+struct triangle final : shape {
+  int base = 0;
+  int height = 0;
+  triangle() = default;
+  explicit triangle(int side) : base(side), height(side) {}
+  int area() const override { return base * height / 2; }
+};
+
+using shape_ptr = static_ptr::static_ptr<shape, sizeof(rectangle)>;
+using shape_collection = static_ptr::poly_collection<shape, sizeof(rectangle)>;
+
+// pseudo-random type order so the branch predictor can't follow it
+template <typename F>
+static void fill(int n, F&& f)
+{
+  unsigned x = 12345;
+  for (int i = 0; i < n; i++) {
+    x = x * 1103515245 + 12345;
+    f(i, (x >> 16) % 3);
+  }
+}
+
+static void BM_VectorOfStaticPtr(benchmark::State& state)
+{
+  std::vector<shape_ptr> v;
+  fill(state.range(0), [&] (int i, unsigned type) {
+    switch (type) {
+      case 0: v.push_back(shape_ptr::make<square>(i)); break;
+      case 1: v.push_back(shape_ptr::make<rectangle>(i)); break;
+      default: v.push_back(shape_ptr::make<triangle>(i)); break;
+    }
+  });
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& p : v) {
+      sum += p->area();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename ...Us>
+static void BM_PolyCollection(benchmark::State& state)
+{
+  shape_collection c;
+  fill(state.range(0), [&] (int i, unsigned type) {
+    switch (type) {
+      case 0: c.emplace<square>(i); break;
+      case 1: c.emplace<rectangle>(i); break;
+      default: c.emplace<triangle>(i); break;
+    }
+  });
+  for (auto _ : state) {
+    int sum = 0;
+    c.for_each<Us...>([&sum] (const shape& s) { sum += s.area(); });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_VectorOfStaticPtr)->Range(64, 64 << 10);
+// generic loop through shape&, but segregated by type
+BENCHMARK_TEMPLATE(BM_PolyCollection)->Range(64, 64 << 10);
+// statically typed loops for every type
+BENCHMARK_TEMPLATE(BM_PolyCollection, square, rectangle, triangle)->Range(64, 64 << 10);
+
+BENCHMARK_MAIN();
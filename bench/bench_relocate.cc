@@ -0,0 +1,98 @@
+#include <static_ptr/static_ptr_algorithm.hpp>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+
+// compare relocating arrays of static_ptrs one element at a time, as a
+// growing container would with move construct + destroy, against
+// uninitialized_relocate_n, over long runs of each type and over
+// interleaved types
+
+// copies may throw, as they do for named
+struct shape {
+  shape() = default;
+  shape(const shape&) {}
+  shape(shape&&) noexcept {}
+  shape& operator=(const shape&) { return *this; }
+  shape& operator=(shape&&) noexcept { return *this; }
+  virtual ~shape() {}
+  virtual int area() const { return 0; }
+};
+// not trivially relocatable, so each element needs a typed relocation
+struct named : shape {
+  std::string name;
+  named() = default;
+  explicit named(int i) : name(std::to_string(i)) {}
+  int area() const override { return static_cast<int>(name.size()); }
+};
+struct square : shape {
+  int side = 0;
+  square() = default;
+  explicit square(int side) : side(side) {}
+  int area() const override { return side * side; }
+};
+
+namespace static_ptr {
+template <> struct is_trivially_relocatable<square> : std::true_type {};
+} // namespace static_ptr
+
+using shape_ptr = static_ptr::static_ptr<shape, sizeof(named)>;
+
+// uninitialized storage for n handles
+struct storage {
+  std::unique_ptr<unsigned char[]> bytes;
+  explicit storage(size_t n) : bytes(new unsigned char[n * sizeof(shape_ptr)]) {}
+  shape_ptr* get() { return reinterpret_cast<shape_ptr*>(bytes.get()); }
+};
+
+// the given percentage of named elements, either grouped at the front or
+// scattered at random
+static void fill(shape_ptr* p, int n, int named_percent, bool grouped)
+{
+  std::mt19937 rng{42};
+  const int named_count = n * named_percent / 100;
+  for (int i = 0; i < n; i++) {
+    const bool is_named = grouped ? i < named_count :
+        static_cast<int>(rng() % 100) < named_percent;
+    if (is_named) {
+      new (&p[i]) shape_ptr{static_ptr::in_place_t<named>{}, i};
+    } else {
+      new (&p[i]) shape_ptr{static_ptr::in_place_t<square>{}, i};
+    }
+  }
+}
+
+template <bool Bulk>
+static void BM_Relocate(benchmark::State& state)
+{
+  const int n = state.range(0);
+  storage a(n), b(n);
+  fill(a.get(), n, state.range(1), state.range(2));
+  shape_ptr* src = a.get();
+  shape_ptr* dst = b.get();
+  for (auto _ : state) {
+    if (Bulk) {
+      static_ptr::uninitialized_relocate_n(src, n, dst);
+    } else {
+      for (int i = 0; i < n; i++) {
+        new (&dst[i]) shape_ptr(std::move(src[i]));
+        src[i].~shape_ptr();
+      }
+    }
+    std::swap(src, dst);
+    benchmark::DoNotOptimize(src);
+  }
+  static_ptr::destroy_n(src, n);
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// arguments are the element count, the percentage of named elements, and
+// whether they're grouped into one run
+#define RELOCATE_ARGS \
+  ArgsProduct({{1 << 8, 1 << 12}, {0, 10, 100}, {1, 0}})
+
+BENCHMARK_TEMPLATE(BM_Relocate, false)->RELOCATE_ARGS;
+BENCHMARK_TEMPLATE(BM_Relocate, true)->RELOCATE_ARGS;
+
+BENCHMARK_MAIN();
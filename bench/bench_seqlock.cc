@@ -0,0 +1,68 @@
+#include <static_ptr/seqlock_static_ptr.hpp>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <mutex>
+
+// read throughput of a published routing object, with one thread also
+// writing a new object every few reads
+
+struct route {
+  std::uint64_t version = 0;
+  std::uint32_t next_hop[6] = {};
+  route() = default;
+  explicit route(std::uint64_t v) : version(v) {}
+};
+struct weighted_route : route {
+  std::uint32_t weights[6] = {};
+  weighted_route() = default;
+  explicit weighted_route(std::uint64_t v) : route(v) {}
+};
+
+using route_ptr = static_ptr::static_ptr<route, sizeof(weighted_route)>;
+
+/// the baseline: a static_ptr behind a mutex
+class mutex_slot {
+  mutable std::mutex mutex;
+  route_ptr p;
+ public:
+  template <typename U>
+  void emplace(std::uint64_t v) {
+    std::lock_guard<std::mutex> lock{mutex};
+    p.emplace<U>(v);
+  }
+  void load(route_ptr& out) const {
+    std::lock_guard<std::mutex> lock{mutex};
+    out = p;
+  }
+};
+
+using seqlock_slot = static_ptr::seqlock_static_ptr<route, sizeof(weighted_route)>;
+
+/// the number of reads between writes on thread 0, when the writer is enabled
+/// by a nonzero argument
+constexpr int64_t write_interval = 64;
+
+template <typename Slot>
+static void BM_Read(benchmark::State& state)
+{
+  static Slot slot;
+  if (state.thread_index() == 0) {
+    slot.template emplace<route>(0);
+  }
+  const bool writer = state.thread_index() == 0 && state.range(0);
+  route_ptr p;
+  std::uint64_t v = 0;
+  for (auto _ : state) {
+    if (writer && ++v % write_interval == 0) {
+      slot.template emplace<weighted_route>(v);
+    }
+    slot.load(p);
+    benchmark::DoNotOptimize(p->version);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_Read, mutex_slot)->Arg(0)->Arg(1)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(BM_Read, seqlock_slot)->Arg(0)->Arg(1)->ThreadRange(1, 8);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,128 @@
+#include <static_ptr/static_ptr.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// compare std::sort and std::rotate over vectors of static_ptrs that are
+// swapped by relocation against ones that go through std::swap, i.e. three
+// type-erased moves of a temporary
+
+struct shape {
+  int key;
+  explicit shape(int key) : key(key) {}
+  virtual ~shape() {}
+  virtual int area() const { return 0; }
+};
+struct square : shape {
+  int side;
+  square(int key, int side) : shape(key), side(side) {}
+  int area() const override { return side * side; }
+};
+struct rect : shape {
+  int width, height;
+  rect(int key, int width, int height)
+    : shape(key), width(width), height(height) {}
+  int area() const override { return width * height; }
+};
+
+// the same hierarchy, declared trivially relocatable so swaps are byte swaps
+struct fast_shape {
+  int key;
+  explicit fast_shape(int key) : key(key) {}
+  virtual ~fast_shape() {}
+  virtual int area() const { return 0; }
+};
+struct fast_square : fast_shape {
+  int side;
+  fast_square(int key, int side) : fast_shape(key), side(side) {}
+  int area() const override { return side * side; }
+};
+struct fast_rect : fast_shape {
+  int width, height;
+  fast_rect(int key, int width, int height)
+    : fast_shape(key), width(width), height(height) {}
+  int area() const override { return width * height; }
+};
+
+namespace static_ptr {
+template <> struct is_trivially_relocatable<fast_shape> : std::true_type {};
+template <> struct is_trivially_relocatable<fast_square> : std::true_type {};
+template <> struct is_trivially_relocatable<fast_rect> : std::true_type {};
+} // namespace static_ptr
+
+using shape_ptr = static_ptr::static_ptr<shape, sizeof(rect)>;
+using fast_shape_ptr = static_ptr::static_ptr<fast_shape, sizeof(fast_rect)>;
+
+// hides the swap overload of Ptr, so algorithms fall back to std::swap
+template <typename Ptr>
+struct std_swapped {
+  Ptr p;
+  decltype(std::declval<Ptr&>().get()) operator->() { return p.get(); }
+  decltype(std::declval<const Ptr&>().get()) operator->() const {
+    return p.get();
+  }
+};
+
+template <typename Ptr, typename Square, typename Rect>
+static Ptr make_shape(int i, int key)
+{
+  if (i % 2) {
+    return Ptr::template make<Square>(key, i);
+  }
+  return Ptr::template make<Rect>(key, i, i + 1);
+}
+
+template <typename Element, typename Ptr, typename Square, typename Rect>
+static std::vector<Element> make_shapes(int count)
+{
+  std::mt19937 rng{42};
+  std::vector<Element> v;
+  v.reserve(count);
+  for (int i = 0; i < count; i++) {
+    v.push_back(Element{make_shape<Ptr, Square, Rect>(i, rng())});
+  }
+  return v;
+}
+
+template <typename Element, typename Ptr, typename Square, typename Rect>
+static void BM_Sort(benchmark::State& state)
+{
+  const auto shapes = make_shapes<Element, Ptr, Square, Rect>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = shapes;
+    state.ResumeTiming();
+    std::sort(v.begin(), v.end(), [] (const Element& l, const Element& r) {
+      return l->key < r->key;
+    });
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Element, typename Ptr, typename Square, typename Rect>
+static void BM_Rotate(benchmark::State& state)
+{
+  auto v = make_shapes<Element, Ptr, Square, Rect>(state.range(0));
+  for (auto _ : state) {
+    std::rotate(v.begin(), v.begin() + v.size() / 3, v.end());
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define SWAP_BENCHMARK(bm) \
+  BENCHMARK_TEMPLATE(bm, std_swapped<shape_ptr>, shape_ptr, square, rect) \
+      ->Range(1 << 10, 1 << 16); \
+  BENCHMARK_TEMPLATE(bm, shape_ptr, shape_ptr, square, rect) \
+      ->Range(1 << 10, 1 << 16); \
+  BENCHMARK_TEMPLATE(bm, std_swapped<fast_shape_ptr>, fast_shape_ptr, \
+                     fast_square, fast_rect)->Range(1 << 10, 1 << 16); \
+  BENCHMARK_TEMPLATE(bm, fast_shape_ptr, fast_shape_ptr, \
+                     fast_square, fast_rect)->Range(1 << 10, 1 << 16)
+
+SWAP_BENCHMARK(BM_Sort);
+SWAP_BENCHMARK(BM_Rotate);
+
+BENCHMARK_MAIN();
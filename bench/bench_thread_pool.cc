@@ -0,0 +1,137 @@
+#include <static_ptr/static_thread_pool.hpp>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// compare static_thread_pool against a pool of std::functions in a single
+// mutex-guarded queue, in tasks per second
+
+class mutex_pool {
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable idle;
+  std::deque<std::function<void()>> tasks;
+  size_t pending = 0;
+  bool stopping = false;
+
+  void worker_loop() {
+    std::unique_lock<std::mutex> lock{mutex};
+    for (;;) {
+      while (!stopping && tasks.empty()) {
+        wake.wait(lock);
+      }
+      if (tasks.empty()) {
+        return;
+      }
+      auto task = std::move(tasks.front());
+      tasks.pop_front();
+      lock.unlock();
+      task();
+      task = nullptr;
+      lock.lock();
+      if (--pending == 0) {
+        idle.notify_all();
+      }
+    }
+  }
+ public:
+  explicit mutex_pool(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      threads.emplace_back(&mutex_pool::worker_loop, this);
+    }
+  }
+  ~mutex_pool() {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+  template <typename F>
+  void submit(F&& f) {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      tasks.emplace_back(std::forward<F>(f));
+      ++pending;
+    }
+    wake.notify_one();
+  }
+  void wait() {
+    std::unique_lock<std::mutex> lock{mutex};
+    while (pending) {
+      idle.wait(lock);
+    }
+  }
+};
+
+using static_pool = static_ptr::static_thread_pool<64>;
+
+// a capture too large for std::function's small buffer
+struct task_body {
+  std::atomic<long>* sum;
+  long values[4];
+  void operator()() const { *sum += values[0] + values[3]; }
+};
+
+// submit a batch of tasks from outside the pool and wait for them
+template <typename Pool>
+static void BM_External(benchmark::State& state)
+{
+  Pool pool(state.range(0));
+  std::atomic<long> sum{0};
+  constexpr int batch = 4096;
+  for (auto _ : state) {
+    for (int i = 0; i < batch; i++) {
+      pool.submit(task_body{&sum, {i, 0, 0, 1}});
+    }
+    pool.wait();
+  }
+  benchmark::DoNotOptimize(sum.load());
+  state.SetItemsProcessed(state.iterations() * batch);
+}
+
+template <typename Pool>
+static void spawn(Pool& pool, std::atomic<long>& sum, int depth)
+{
+  if (depth == 0) {
+    sum++;
+    return;
+  }
+  pool.submit([&pool, &sum, depth] { spawn(pool, sum, depth - 1); });
+  pool.submit([&pool, &sum, depth] { spawn(pool, sum, depth - 1); });
+}
+
+// a binary tree of tasks that submit their children from inside the pool
+template <typename Pool>
+static void BM_Recursive(benchmark::State& state)
+{
+  Pool pool(state.range(0));
+  std::atomic<long> sum{0};
+  constexpr int depth = 12;
+  for (auto _ : state) {
+    pool.submit([&pool, &sum] { spawn(pool, sum, depth); });
+    pool.wait();
+  }
+  benchmark::DoNotOptimize(sum.load());
+  state.SetItemsProcessed(state.iterations() * ((2 << depth) - 1));
+}
+
+BENCHMARK_TEMPLATE(BM_External, mutex_pool)->RangeMultiplier(2)->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_External, static_pool)->RangeMultiplier(2)->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Recursive, mutex_pool)->RangeMultiplier(2)->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Recursive, static_pool)->RangeMultiplier(2)->Range(1, 8)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+// errors that would throw, i.e. bad_static_any_cast, bad_function_call and
+// std::logic_error, are passed to the abort handler instead in builds without
+// exceptions. exceptions are detected from the compiler flags, e.g.
+// -fno-exceptions; define STATIC_PTR_NO_EXCEPTIONS to select this mode with
+// exceptions enabled too
+#if !defined(STATIC_PTR_NO_EXCEPTIONS) && !defined(__cpp_exceptions) && \
+    !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+#define STATIC_PTR_NO_EXCEPTIONS
+#endif
+
+namespace static_ptr {
+
+/// called with a description of the error. std::abort is called if it
+/// returns
+using abort_handler = void (*)(const char* what);
+
+namespace _ {
+
+inline std::atomic<abort_handler>& abort_handler_storage() noexcept {
+  static std::atomic<abort_handler> handler{nullptr};
+  return handler;
+}
+
+/// call the abort handler, or print what to stderr without one, then abort
+[[noreturn]] inline void abort_with(const char* what) noexcept {
+  if (auto handler = abort_handler_storage().load(std::memory_order_acquire)) {
+    handler(what);
+  } else {
+    std::fprintf(stderr, "static_ptr: %s\n", what);
+  }
+  std::abort();
+}
+
+/// throw e, or pass e.what() to the abort handler without exceptions
+template <typename E>
+[[noreturn]] void throw_or_abort(const E& e) {
+#ifdef STATIC_PTR_NO_EXCEPTIONS
+  abort_with(e.what());
+#else
+  throw e;
+#endif
+}
+
+} // namespace _
+
+/// replace the abort handler, returning the previous one. null restores the
+/// default, which prints the error to stderr
+inline abort_handler set_abort_handler(abort_handler handler) noexcept {
+  return _::abort_handler_storage().exchange(handler,
+                                             std::memory_order_acq_rel);
+}
+
+} // namespace static_ptr
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <cstdint>
+
+namespace static_ptr {
+
+namespace _ {
+
+template <typename T, typename ...Ts>
+struct first_of { using type = T; };
+
+} // namespace _
+
+/// a static_ptr for a closed set of types Us derived from Base. the buffer
+/// size and alignment are the max over Us, and the dynamic type is stored as
+/// a one-byte index, which fits in the tail padding of the buffer whenever
+/// its size isn't a multiple of its alignment. operations dispatch through
+/// per-index tables of typed functions, and visit() calls a visitor with the
+/// fully typed object
+template <typename Base, typename ...Us>
+class closed_static_ptr : _::deleted_ops<Base> {
+  static_assert(sizeof...(Us) > 0, "closed_static_ptr requires types");
+  static_assert(sizeof...(Us) < 256, "too many types for a one-byte index");
+  static_assert(_::all_of(std::is_base_of<Base, Us>::value...),
+                "closed_static_ptr types must derive from Base");
+  static_assert(_::all_of(_::supports_same_ops<Base, Us>::value...),
+                "closed_static_ptr types must support the operations of Base");
+
+ public:
+  static constexpr size_t size = _::max_of(sizeof(Us)...);
+  static constexpr size_t alignment = _::max_of(alignof(Base), alignof(Us)...);
+
+ private:
+  alignas(alignment) unsigned char buffer[size];
+
+  /// 1-based index into Us of the stored type, 0 while empty
+  std::uint8_t index{0};
+
+  static constexpr bool trivial_relocate =
+      _::all_of(is_trivially_relocatable<Us>::value...);
+  static constexpr bool trivial_copy =
+      _::all_of(std::is_trivially_copyable<Us>::value...);
+  static constexpr bool trivial_destruct =
+      _::all_of(std::is_trivially_destructible<Us>::value...);
+
+  // per-index tables of the typed operations, null where trivial and shared
+  // where disabled
+  using relocate_fn = void (*)(void* dst, void* src);
+  using copy_fn = void (*)(void* dst, const void* src);
+  using destruct_fn = void (*)(void* dst);
+
+  static relocate_fn relocate_op(size_t i) {
+    static const relocate_fn table[] = {
+      _::op_table_for<Us>::trivial_relocate ? nullptr :
+          _::op_table_for<Us>::relocate_op(
+              typename _::op_table_for<Us>::can_relocate{})...
+    };
+    return table[i - 1];
+  }
+  static relocate_fn relocate_assign_op(size_t i) {
+    static const relocate_fn table[] = {
+      _::op_table_for<Us>::trivial_relocate ? nullptr :
+          _::op_table_for<Us>::relocate_assign_op(
+              typename _::op_table_for<Us>::can_relocate_assign{})...
+    };
+    return table[i - 1];
+  }
+  static copy_fn copy_construct_op(size_t i) {
+    static const copy_fn table[] = {
+      _::op_table_for<Us>::trivial_copy ? nullptr :
+          _::op_table_for<Us>::copy_construct_op(
+              typename _::op_table_for<Us>::can_copy{})...
+    };
+    return table[i - 1];
+  }
+  static copy_fn copy_assign_op(size_t i) {
+    static const copy_fn table[] = {
+      _::op_table_for<Us>::trivial_copy ? nullptr :
+          _::op_table_for<Us>::copy_assign_op(
+              typename _::op_table_for<Us>::can_copy_assign{})...
+    };
+    return table[i - 1];
+  }
+  static destruct_fn destruct_op(size_t i) {
+    static const destruct_fn table[] = {
+      _::op_table_for<Us>::trivial_destruct ? nullptr : &_::op_table_for<Us>::destruct...
+    };
+    return table[i - 1];
+  }
+
+  void destroy() noexcept(std::is_nothrow_destructible<Base>::value) {
+    if (index) {
+      if (!trivial_destruct) {
+        if (auto destruct = destruct_op(index)) {
+          destruct(buffer);
+        }
+      }
+      index = 0;
+    }
+  }
+
+  void move_from(closed_static_ptr& o) {
+    if (o.index) {
+      if (trivial_relocate) {
+        std::memcpy(buffer, o.buffer, size);
+      } else if (auto relocate = relocate_op(o.index)) {
+        relocate(buffer, o.buffer);
+      } else {
+        std::memcpy(buffer, o.buffer, size);
+      }
+      index = o.index;
+      o.index = 0;
+    }
+  }
+
+  void copy_from(const closed_static_ptr& o) {
+    if (o.index) {
+      if (trivial_copy) {
+        std::memcpy(buffer, o.buffer, size);
+      } else if (auto copy_construct = copy_construct_op(o.index)) {
+        copy_construct(buffer, o.buffer);
+      } else {
+        std::memcpy(buffer, o.buffer, size);
+      }
+      index = o.index;
+    }
+  }
+
+  template <typename R, typename F, typename U>
+  static R invoke(F& f, void* p) {
+    return f(*static_cast<U*>(p));
+  }
+  template <typename R, typename F, typename U>
+  static R invoke_const(F& f, const void* p) {
+    return f(*static_cast<const U*>(p));
+  }
+
+  using first_type = typename _::first_of<Us...>::type;
+
+ public:
+  /// the 1-based index of U in Us, 0 if U is not in Us
+  template <typename U>
+  static constexpr size_t index_of() {
+    return _::index_of<typename std::decay<U>::type, Us...>::value;
+  }
+
+  closed_static_ptr() = default;
+  ~closed_static_ptr() {
+    destroy();
+  }
+
+  /// initializing constructor
+  template <typename U, typename ...Args>
+  closed_static_ptr(in_place_t<U>, Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value) {
+    static_assert(index_of<U>() != 0, "type is not in the closed set");
+    STATIC_PTR_RECORD(U, construct);
+    new (buffer) U(std::forward<Args>(args)...);
+    index = index_of<U>();
+  }
+
+  /// in-place (re)initialization
+  template <typename U, typename ...Args>
+  void emplace(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value &&
+               std::is_nothrow_destructible<Base>::value) {
+    static_assert(index_of<U>() != 0, "type is not in the closed set");
+    destroy();
+    STATIC_PTR_RECORD(U, construct);
+    new (buffer) U(std::forward<Args>(args)...);
+    index = index_of<U>();
+  }
+
+  // move operations
+  closed_static_ptr(closed_static_ptr&& o)
+      noexcept(_::all_of(is_trivially_relocatable<Us>::value ||
+                         _::relocater<Us>::is_noexcept...)) {
+    move_from(o);
+  }
+  closed_static_ptr& operator=(closed_static_ptr&& o)
+      noexcept(_::all_of(is_trivially_relocatable<Us>::value ||
+                         (_::relocater<Us>::is_noexcept &&
+                          _::relocate_assigner<Us>::is_noexcept)...)) {
+    if (index && index == o.index && !trivial_relocate) {
+      // same type, move assign
+      if (auto relocate_assign = relocate_assign_op(index)) {
+        relocate_assign(buffer, o.buffer);
+        o.index = 0;
+        return *this;
+      }
+    }
+    destroy();
+    move_from(o);
+    return *this;
+  }
+
+  // copy operations
+  closed_static_ptr(const closed_static_ptr& o)
+      noexcept(_::all_of(std::is_trivially_copyable<Us>::value ||
+                         _::copy_constructer<Us>::is_noexcept...)) {
+    copy_from(o);
+  }
+  closed_static_ptr& operator=(const closed_static_ptr& o)
+      noexcept(_::all_of(std::is_trivially_copyable<Us>::value ||
+                         (_::copy_constructer<Us>::is_noexcept &&
+                          _::copy_assigner<Us>::is_noexcept)...)) {
+    if (index && index == o.index && !trivial_copy) {
+      // same type, copy assign
+      if (auto copy_assign = copy_assign_op(index)) {
+        copy_assign(buffer, o.buffer);
+        return *this;
+      }
+    }
+    if (this != &o) {
+      destroy();
+      copy_from(o);
+    }
+    return *this;
+  }
+
+  /// destruct an existing instance
+  void reset() noexcept(std::is_nothrow_destructible<Base>::value) {
+    destroy();
+  }
+
+  /// the 1-based index of the stored type in Us, 0 while empty
+  size_t type_index() const noexcept { return index; }
+
+  /// whether the stored type is U
+  template <typename U>
+  bool holds() const noexcept { return index && index == index_of<U>(); }
+
+  /// call f with a reference to the stored object as its actual type. the
+  /// pointer must not be empty. returns the result of f
+  template <typename F>
+  auto visit(F&& f) -> decltype(f(std::declval<first_type&>())) {
+    using R = decltype(f(std::declval<first_type&>()));
+    using fn = R (*)(F&, void*);
+    static const fn table[] = { &closed_static_ptr::invoke<R, F, Us>... };
+    return table[index - 1](f, buffer);
+  }
+  template <typename F>
+  auto visit(F&& f) const -> decltype(f(std::declval<const first_type&>())) {
+    using R = decltype(f(std::declval<const first_type&>()));
+    using fn = R (*)(F&, const void*);
+    static const fn table[] = { &closed_static_ptr::invoke_const<R, F, Us>... };
+    return table[index - 1](f, buffer);
+  }
+
+  /// base pointer accessors
+  Base* get() noexcept {
+    return index ? reinterpret_cast<Base*>(buffer) : nullptr;
+  }
+  const Base* get() const noexcept {
+    return index ? reinterpret_cast<const Base*>(buffer) : nullptr;
+  }
+
+  Base& operator*() noexcept { return *get(); }
+  const Base& operator*() const noexcept { return *get(); }
+
+  Base* operator->() noexcept { return get(); }
+  const Base* operator->() const noexcept { return get(); }
+
+  operator bool() const noexcept { return index != 0; }
+
+  /// member factory function
+  template <typename U, typename ...Args>
+  static closed_static_ptr make(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value) {
+    return {in_place_t<U>{}, std::forward<Args>(args)...};
+  }
+};
+
+template <typename Base, typename ...Us>
+constexpr size_t closed_static_ptr<Base, Us...>::size;
+template <typename Base, typename ...Us>
+constexpr size_t closed_static_ptr<Base, Us...>::alignment;
+
+} // namespace static_ptr
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include <typeinfo>
+
+// opt-in accounting of the memory that static_ptr handles reserve versus the
+// memory their objects use, per instantiation. define
+// STATIC_PTR_ENABLE_LAYOUT_STATS before including any static_ptr header,
+// consistently in every translation unit; otherwise it compiles out entirely.
+// covers the handles built on basic_static_ptr, i.e. static_ptr and
+// static_any. counting handles at runtime means they can no longer be
+// constant-initialized in c++20
+
+namespace static_ptr {
+
+/// live handles and objects of one basic_static_ptr<T, S, A> instantiation.
+/// statistics are only linked into the registry once the instantiation
+/// creates its first handle
+class layout_stats {
+  const std::type_info* info;
+  size_t buffer;
+  size_t align;
+  size_t handle;
+  std::atomic<long long> live_handles;
+  std::atomic<long long> live_objects;
+  std::atomic<long long> live_bytes;
+  std::atomic<bool> linked;
+  layout_stats* next{nullptr};
+  friend class layout_registry;
+
+  void link() noexcept;
+
+ public:
+  constexpr layout_stats(const std::type_info* info, size_t buffer,
+                         size_t align, size_t handle) noexcept
+    : info(info), buffer(buffer), align(align), handle(handle),
+      live_handles{0}, live_objects{0}, live_bytes{0}, linked{false} {}
+  layout_stats(const layout_stats&) = delete;
+  layout_stats& operator=(const layout_stats&) = delete;
+
+  /// the static type T
+  const std::type_info& type() const noexcept { return *info; }
+  /// S, A and the size of the handle
+  size_t buffer_size() const noexcept { return buffer; }
+  size_t alignment() const noexcept { return align; }
+  size_t handle_size() const noexcept { return handle; }
+
+  long long handles() const noexcept {
+    return live_handles.load(std::memory_order_relaxed);
+  }
+  long long objects() const noexcept {
+    return live_objects.load(std::memory_order_relaxed);
+  }
+  /// bytes reserved by the live handles
+  long long reserved_bytes() const noexcept { return handles() * handle; }
+  /// bytes of the live objects
+  long long used_bytes() const noexcept {
+    return live_bytes.load(std::memory_order_relaxed);
+  }
+
+  void add_handle() noexcept {
+    live_handles.fetch_add(1, std::memory_order_relaxed);
+    if (!linked.load(std::memory_order_relaxed)) {
+      link();
+    }
+  }
+  void remove_handle() noexcept {
+    live_handles.fetch_sub(1, std::memory_order_relaxed);
+  }
+  /// count an object of size bytes stored in, or removed from, a handle
+  void add_object(size_t size) noexcept {
+    live_objects.fetch_add(1, std::memory_order_relaxed);
+    live_bytes.fetch_add(static_cast<long long>(size),
+                         std::memory_order_relaxed);
+  }
+  void remove_object(size_t size) noexcept {
+    live_objects.fetch_sub(1, std::memory_order_relaxed);
+    live_bytes.fetch_sub(static_cast<long long>(size),
+                         std::memory_order_relaxed);
+  }
+};
+
+/// registry of the layout_stats of each instantiation that has created a
+/// handle
+class layout_registry {
+  friend class layout_stats;
+
+  static std::atomic<layout_stats*>& head() noexcept {
+    static std::atomic<layout_stats*> list{nullptr};
+    return list;
+  }
+
+ public:
+  /// call f(const layout_stats&) for each instantiation, most recently seen
+  /// first
+  template <typename F>
+  static void for_each(F&& f) {
+    for (auto s = head().load(std::memory_order_acquire); s; s = s->next) {
+      f(static_cast<const layout_stats&>(*s));
+    }
+  }
+
+  /// bytes reserved by all live handles
+  static long long reserved_bytes() noexcept {
+    long long total = 0;
+    for_each([&total] (const layout_stats& s) { total += s.reserved_bytes(); });
+    return total;
+  }
+  /// bytes of all live objects
+  static long long used_bytes() noexcept {
+    long long total = 0;
+    for_each([&total] (const layout_stats& s) { total += s.used_bytes(); });
+    return total;
+  }
+
+  /// write one line per instantiation with live handles, with mangled type
+  /// names, followed by the totals
+  static void dump(std::ostream& out) {
+    for_each([&out] (const layout_stats& s) {
+      if (!s.handles()) {
+        return;
+      }
+      out << s.type().name() << " S=" << s.buffer_size()
+          << " A=" << s.alignment() << " handle=" << s.handle_size()
+          << ": handles=" << s.handles() << " objects=" << s.objects()
+          << " reserved=" << s.reserved_bytes()
+          << " used=" << s.used_bytes() << '\n';
+    });
+    out << "total: reserved=" << reserved_bytes()
+        << " used=" << used_bytes() << '\n';
+  }
+};
+
+inline void layout_stats::link() noexcept
+{
+  if (linked.exchange(true, std::memory_order_relaxed)) {
+    return;
+  }
+  auto& list = layout_registry::head();
+  next = list.load(std::memory_order_relaxed);
+  while (!list.compare_exchange_weak(next, this, std::memory_order_release,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+} // namespace static_ptr
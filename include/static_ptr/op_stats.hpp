@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include <typeinfo>
+
+// opt-in instrumentation of the operations that static_ptr and its relatives
+// perform on stored types. define STATIC_PTR_ENABLE_OP_STATS before including
+// any static_ptr header, consistently in every translation unit, to count
+// operations per type; otherwise the counting compiles out entirely
+
+namespace static_ptr {
+
+/// operations counted per stored type
+enum class op_event {
+  /// construction of a new object in a buffer
+  construct,
+  /// move construction, relocation or move assignment, including memcpy
+  /// of trivially relocatable types
+  move,
+  /// copy construction or copy assignment, including memcpy of trivially
+  /// copyable types
+  copy,
+  /// move construction done as default construct + move assign
+  move_construct_fallback,
+  /// move assignment done as destruct + move construct
+  move_assign_fallback,
+  /// copy construction done as default construct + copy assign
+  copy_construct_fallback,
+  /// assignment over an object of a different type, which destructs the
+  /// old object and constructs the new one. counted for the new type
+  cross_type_assign,
+};
+
+/// number of op_event values
+constexpr size_t op_event_count = 7;
+
+/// name of an op_event, for dumps
+inline const char* op_event_name(op_event e) noexcept {
+  static const char* const names[op_event_count] = {
+    "construct", "move", "copy", "move_construct_fallback",
+    "move_assign_fallback", "copy_construct_fallback", "cross_type_assign",
+  };
+  return names[static_cast<size_t>(e)];
+}
+
+/// counters for one stored type. statistics are only linked into the
+/// registry once the type records its first operation
+class type_stats {
+  const std::type_info* info;
+  std::atomic<unsigned long long> counts[op_event_count];
+  std::atomic<bool> linked;
+  type_stats* next{nullptr};
+  friend class op_stats;
+
+ public:
+  constexpr explicit type_stats(const std::type_info* info) noexcept
+    : info(info), counts{}, linked{false} {}
+  type_stats(const type_stats&) = delete;
+  type_stats& operator=(const type_stats&) = delete;
+
+  const std::type_info& type() const noexcept { return *info; }
+
+  unsigned long long count(op_event e) const noexcept {
+    return counts[static_cast<size_t>(e)].load(std::memory_order_relaxed);
+  }
+};
+
+namespace _ {
+
+/// the statistics of type T
+template <typename T>
+struct type_stats_for {
+  static type_stats stats;
+};
+template <typename T>
+type_stats type_stats_for<T>::stats{&typeid(T)};
+
+} // namespace _
+
+/// registry of the statistics of every type that has recorded an operation,
+/// and an optional hook that's called on every operation
+class op_stats {
+ public:
+  /// called after each operation is counted. must not throw, and must be
+  /// safe to call from any thread
+  using hook_fn = void (*)(const type_stats& stats, op_event e);
+
+  /// install a hook, or remove it with null. returns the previous hook
+  static hook_fn set_hook(hook_fn hook) noexcept {
+    return hook_storage().exchange(hook, std::memory_order_acq_rel);
+  }
+
+  /// the statistics of type T, whether or not it has recorded anything
+  template <typename T>
+  static const type_stats& get() noexcept {
+    return _::type_stats_for<T>::stats;
+  }
+
+  /// call f(const type_stats&) for each type that has recorded operations,
+  /// most recently seen types first
+  template <typename F>
+  static void for_each(F&& f) {
+    for (auto s = head().load(std::memory_order_acquire); s; s = s->next) {
+      f(static_cast<const type_stats&>(*s));
+    }
+  }
+
+  /// zero all counters
+  static void reset() noexcept {
+    for (auto s = head().load(std::memory_order_acquire); s; s = s->next) {
+      for (auto& c : s->counts) {
+        c.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// write the nonzero counters of each type, one type per line, with
+  /// mangled type names
+  static void dump(std::ostream& out) {
+    for_each([&out] (const type_stats& s) {
+      out << s.type().name() << ':';
+      for (size_t i = 0; i < op_event_count; i++) {
+        const auto e = static_cast<op_event>(i);
+        if (auto n = s.count(e)) {
+          out << ' ' << op_event_name(e) << '=' << n;
+        }
+      }
+      out << '\n';
+    });
+  }
+
+  /// count an operation on the type with statistics s
+  static void record(type_stats& s, op_event e) noexcept {
+    s.counts[static_cast<size_t>(e)].fetch_add(1, std::memory_order_relaxed);
+    if (!s.linked.load(std::memory_order_relaxed) &&
+        !s.linked.exchange(true, std::memory_order_relaxed)) {
+      auto& list = head();
+      s.next = list.load(std::memory_order_relaxed);
+      while (!list.compare_exchange_weak(s.next, &s,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+      }
+    }
+    if (auto hook = hook_storage().load(std::memory_order_acquire)) {
+      hook(s, e);
+    }
+  }
+  template <typename T>
+  static void record(op_event e) noexcept {
+    record(_::type_stats_for<T>::stats, e);
+  }
+
+ private:
+  static std::atomic<type_stats*>& head() noexcept {
+    static std::atomic<type_stats*> list{nullptr};
+    return list;
+  }
+  static std::atomic<hook_fn>& hook_storage() noexcept {
+    static std::atomic<hook_fn> hook{nullptr};
+    return hook;
+  }
+};
+
+} // namespace static_ptr
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <vector>
+
+namespace static_ptr {
+
+namespace _ {
+
+template <typename ...Ts>
+struct type_list {};
+
+/// contiguous array of objects that all have the same dynamic type,
+/// identified by its op table
+template <typename T, size_t S>
+class poly_segment {
+  static_assert(is_trivially_relocatable<T>::value ||
+                relocater<T>::is_noexcept,
+                "poly_collection requires nothrow relocation");
+
+  using buffer_type = typename basic_static_ptr<T, S>::buffer_type;
+  using op_fn = type_erasure_ops::op_fn;
+
+  op_fn ops;
+  buffer_type* data{nullptr};
+  size_t count{0};
+  size_t cap{0};
+
+  /// move the elements into new_data, an array of new_cap buffers, and free
+  /// the current array
+  void adopt(buffer_type* new_data, size_t new_cap) noexcept {
+    if (auto relocate_n = bulk_ops(ops)->relocate_n) {
+      relocate_n(new_data, data, count, sizeof(buffer_type));
+    } else if (count) {
+      std::memcpy(new_data, data, count * sizeof(buffer_type));
+    }
+    delete[] data;
+    data = new_data;
+    cap = new_cap;
+  }
+  void reallocate(size_t new_cap) {
+    adopt(new buffer_type[new_cap], new_cap);
+  }
+
+ public:
+  explicit poly_segment(op_fn ops) noexcept : ops(ops) {}
+  ~poly_segment() {
+    clear();
+    delete[] data;
+  }
+
+  poly_segment(poly_segment&& o) noexcept
+    : ops(o.ops), data(o.data), count(o.count), cap(o.cap) {
+    o.data = nullptr;
+    o.count = o.cap = 0;
+  }
+  poly_segment& operator=(poly_segment&& o) noexcept {
+    if (this != &o) {
+      clear();
+      delete[] data;
+      ops = o.ops;
+      data = o.data;
+      count = o.count;
+      cap = o.cap;
+      o.data = nullptr;
+      o.count = o.cap = 0;
+    }
+    return *this;
+  }
+
+  /// delegates so that the destructor frees data if a copy throws, and
+  /// copy_construct_n destroys the copies it made before throwing
+  poly_segment(const poly_segment& o) : poly_segment(o.ops) {
+    reallocate(o.count);
+    if (auto copy_construct_n = bulk_ops(ops)->copy_construct_n) {
+      copy_construct_n(data, o.data, o.count, sizeof(buffer_type));
+    } else if (o.count) {
+      std::memcpy(data, o.data, o.count * sizeof(buffer_type));
+    }
+    count = o.count;
+  }
+  poly_segment& operator=(const poly_segment& o) {
+    if (this != &o) {
+      poly_segment tmp{o};
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+
+  op_fn type() const noexcept { return ops; }
+  size_t size() const noexcept { return count; }
+
+  template <typename U, typename ...Args>
+  U& emplace_back(Args&&... args) {
+    STATIC_PTR_RECORD(U, construct);
+    if (count == cap) {
+      // construct the element in the new array before moving the others, so
+      // that args may refer to elements of this segment
+      const size_t new_cap = cap ? cap * 2 : 8;
+      struct guard {
+        buffer_type* data;
+        ~guard() { delete[] data; }
+      } g{new buffer_type[new_cap]};
+      auto u = new (&g.data[count]) U(std::forward<Args>(args)...);
+      adopt(g.data, new_cap);
+      g.data = nullptr;
+      ++count;
+      return *u;
+    }
+    auto u = new (&data[count]) U(std::forward<Args>(args)...);
+    ++count;
+    return *u;
+  }
+
+  void clear() noexcept {
+    if (auto destruct_n = bulk_ops(ops)->destruct_n) {
+      destruct_n(data, count, sizeof(buffer_type));
+    }
+    count = 0;
+  }
+
+  /// statically typed loop over a segment known to hold type U
+  template <typename U, typename F>
+  void for_each_as(F& f) {
+    for (size_t i = 0; i < count; i++) {
+      f(*reinterpret_cast<U*>(&data[i]));
+    }
+  }
+  template <typename U, typename F>
+  void for_each_as(F& f) const {
+    for (size_t i = 0; i < count; i++) {
+      f(*reinterpret_cast<const U*>(&data[i]));
+    }
+  }
+};
+
+} // namespace _
+
+/// a collection of polymorphic objects derived from T, each of size up to S,
+/// that groups the objects into one contiguous segment per dynamic type.
+/// for_each<Us...>() runs a statically typed loop over the segments of the
+/// listed types, so their calls can be devirtualized and inlined (mark the
+/// types final to guarantee it), and a generic loop through T& for the rest.
+/// iteration visits one segment at a time, so the order of elements of
+/// different types is not preserved
+template <typename T, size_t S = sizeof(T)>
+class poly_collection : protected _::type_erasure_ops,
+                        _::copy_constructer<T>, _::copy_assigner<T> {
+  static_assert(sizeof(T) <= S, "S is too small for T");
+
+  using segment = _::poly_segment<T, S>;
+  std::vector<segment> segments;
+
+  segment& segment_for(op_fn type) {
+    for (auto& s : segments) {
+      if (s.type() == type) {
+        return s;
+      }
+    }
+    segments.emplace_back(type);
+    return segments.back();
+  }
+
+  template <typename Segment, typename F>
+  static void visit(Segment& s, F& f, _::type_list<>) {
+    s.template for_each_as<T>(f);
+  }
+  template <typename Segment, typename F, typename U, typename ...Us>
+  static void visit(Segment& s, F& f, _::type_list<U, Us...>) {
+    if (s.type() == get_operate<U>()) {
+      s.template for_each_as<U>(f);
+    } else {
+      visit(s, f, _::type_list<Us...>{});
+    }
+  }
+
+ public:
+  /// construct a U in the segment for its type
+  template <typename U = T, typename ...Args>
+  U& emplace(Args&&... args) {
+    static_assert(sizeof(U) <= S,
+                  "size of type is larger than static size");
+    static_assert(alignof(U) <= alignof(T),
+                  "alignment of type is larger than alignment of T");
+    static_assert(std::is_base_of<T, U>::value,
+                  "initializing with incompatible type");
+    static_assert(_::supports_same_ops<T, U>::value,
+                  "move into poly_collection with incompatible type");
+    return segment_for(get_operate<U>()).template emplace_back<U>(
+        std::forward<Args>(args)...);
+  }
+
+  size_t size() const noexcept {
+    size_t n = 0;
+    for (auto& s : segments) {
+      n += s.size();
+    }
+    return n;
+  }
+  bool empty() const noexcept { return size() == 0; }
+
+  /// number of elements with dynamic type U
+  template <typename U>
+  size_t count() const noexcept {
+    for (auto& s : segments) {
+      if (s.type() == get_operate<U>()) {
+        return s.size();
+      }
+    }
+    return 0;
+  }
+
+  void clear() noexcept {
+    for (auto& s : segments) {
+      s.clear();
+    }
+  }
+
+  /// call f(U&) for the elements of each type U in Us, and f(T&) for the
+  /// elements of any other type
+  template <typename ...Us, typename F>
+  void for_each(F&& f) {
+    for (auto& s : segments) {
+      visit(s, f, _::type_list<Us...>{});
+    }
+  }
+  template <typename ...Us, typename F>
+  void for_each(F&& f) const {
+    for (auto& s : segments) {
+      visit(s, f, _::type_list<Us...>{});
+    }
+  }
+};
+
+} // namespace static_ptr
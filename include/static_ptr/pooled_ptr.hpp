@@ -0,0 +1,324 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace static_ptr {
+
+namespace _ {
+
+/// a free slot, linked through its own storage
+struct pool_node {
+  pool_node* next;
+};
+
+/// a list of free slots moved between a thread cache and the depot
+struct pool_batch {
+  pool_node* head;
+  size_t count;
+};
+
+/// deallocates a slot unless released, so construction can throw
+template <typename Pool>
+class pool_slot_guard {
+  void* p;
+ public:
+  explicit pool_slot_guard(void* p) noexcept : p(p) {}
+  ~pool_slot_guard() {
+    if (p) {
+      Pool::deallocate(p);
+    }
+  }
+  void release() noexcept { p = nullptr; }
+};
+
+} // namespace _
+
+/// a pool of fixed-size slots of S bytes aligned to A, for one static_ptr
+/// instantiation's objects that need stable addresses. each thread allocates
+/// from and frees to its own free list, so both are a pointer pop or push.
+/// an empty list refills with a batch of slots from a global depot, and a
+/// list that grows past two batches returns one to the depot. the depot
+/// carves new batches from chunks of memory that are only released at exit,
+/// so all threads that use the pool must be joined before then
+template <size_t S, size_t A = alignof(std::max_align_t)>
+class slot_pool {
+  using node = _::pool_node;
+  using batch = _::pool_batch;
+
+  static constexpr size_t round_up(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+  }
+
+ public:
+  static constexpr size_t alignment = _::max2(A, alignof(node));
+  static constexpr size_t slot_size = round_up(_::max2(S, sizeof(node)),
+                                               alignment);
+  /// slots moved to or from the depot at once, about a page worth
+  static constexpr size_t batch_size = _::max2(8, 4096 / slot_size);
+  /// batches carved from each chunk of memory
+  static constexpr size_t chunk_batches = 8;
+
+ private:
+  /// global store of free batches and owner of the memory
+  class depot {
+    std::mutex mutex;
+    std::vector<batch> batches;
+    std::vector<void*> chunks;
+
+    /// allocate a chunk and split it into batches, with the lock held
+    void grow() {
+      void* chunk = ::operator new(chunk_batches * batch_size * slot_size +
+                                   alignment);
+      chunks.push_back(chunk);
+      auto addr = round_up(reinterpret_cast<std::uintptr_t>(chunk), alignment);
+      auto p = reinterpret_cast<unsigned char*>(addr);
+      for (size_t b = 0; b < chunk_batches; b++) {
+        node* head = nullptr;
+        for (size_t i = 0; i < batch_size; i++, p += slot_size) {
+          auto n = reinterpret_cast<node*>(p);
+          n->next = head;
+          head = n;
+        }
+        batches.push_back(batch{head, batch_size});
+      }
+    }
+
+   public:
+    depot() = default;
+    depot(const depot&) = delete;
+    depot& operator=(const depot&) = delete;
+    ~depot() {
+      for (auto chunk : chunks) {
+        ::operator delete(chunk);
+      }
+    }
+
+    batch pop() {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (batches.empty()) {
+        grow();
+      }
+      auto b = batches.back();
+      batches.pop_back();
+      return b;
+    }
+    void push(batch b) {
+      std::lock_guard<std::mutex> lock{mutex};
+      batches.push_back(b);
+    }
+  };
+
+  static depot& global() {
+    static depot d;
+    return d;
+  }
+
+  /// per-thread free list, which returns its slots to the depot on exit
+  struct cache {
+    node* head{nullptr};
+    size_t count{0};
+
+    cache() {
+      // construct the depot first, so it outlives the caches
+      global();
+    }
+    cache(const cache&) = delete;
+    cache& operator=(const cache&) = delete;
+    ~cache() {
+      if (head) {
+        global().push(batch{head, count});
+      }
+    }
+
+    void refill() {
+      auto b = global().pop();
+      head = b.head;
+      count = b.count;
+    }
+    /// return a batch of n slots from the front of the list to the depot
+    void flush(size_t n) {
+      node* first = head;
+      node* last = head;
+      for (size_t i = 1; i < n; i++) {
+        last = last->next;
+      }
+      head = last->next;
+      count -= n;
+      last->next = nullptr;
+      global().push(batch{first, n});
+    }
+  };
+
+  static cache& local() {
+    static thread_local cache c;
+    return c;
+  }
+
+ public:
+  /// allocate a slot of slot_size bytes aligned to alignment
+  static void* allocate() {
+    cache& c = local();
+    if (!c.head) {
+      c.refill();
+    }
+    node* n = c.head;
+    c.head = n->next;
+    --c.count;
+    return n;
+  }
+
+  /// return a slot from allocate(), possibly allocated by another thread
+  static void deallocate(void* p) noexcept {
+    cache& c = local();
+    auto n = static_cast<node*>(p);
+    n->next = c.head;
+    c.head = n;
+    if (++c.count >= 2 * batch_size) {
+      c.flush(batch_size);
+    }
+  }
+};
+
+template <size_t S, size_t A>
+constexpr size_t slot_pool<S, A>::alignment;
+template <size_t S, size_t A>
+constexpr size_t slot_pool<S, A>::slot_size;
+template <size_t S, size_t A>
+constexpr size_t slot_pool<S, A>::batch_size;
+template <size_t S, size_t A>
+constexpr size_t slot_pool<S, A>::chunk_batches;
+
+/// a unique owner of an object derived from T in a slot of the
+/// slot_pool<S, A> shared by all pooled_ptr<T, S, A>. it holds the same
+/// objects as static_ptr<T, S, A>, but at a stable address, so moves only
+/// transfer the pointer. the object is destroyed through its op table
+template <typename T, size_t S = sizeof(T), size_t A = alignof(T)>
+class pooled_ptr : protected _::type_erasure_ops {
+  static_assert(sizeof(T) <= S, "S is too small for T");
+  static_assert(A >= alignof(T), "A is too small for T");
+
+  /// support conversions of type
+  template <typename U, size_t S2, size_t A2> friend class pooled_ptr;
+
+ public:
+  using pool = slot_pool<S, A>;
+
+ private:
+  void* slot{nullptr};
+  /// op table for the stored type, null while empty
+  op_storage<T> operate;
+
+  void destroy() noexcept(std::is_nothrow_destructible<T>::value) {
+    if (slot) {
+      if (!std::is_trivially_destructible<T>::value) {
+        destruct(slot, operate);
+      }
+      pool::deallocate(slot);
+      slot = nullptr;
+      operate = nullptr;
+    }
+  }
+
+  template <typename U, typename ...Args>
+  static void* construct(Args&&... args) {
+    static_assert(sizeof(U) <= S,
+                  "size of type is larger than static size");
+    static_assert(alignof(U) <= A,
+                  "alignment of type is larger than static alignment");
+    static_assert(std::is_base_of<T, U>::value,
+                  "initializing with incompatible type");
+    static_assert(std::is_trivially_destructible<U>::value ||
+                  !std::is_trivially_destructible<T>::value,
+                  "initializing with incompatible type");
+    void* p = pool::allocate();
+    _::pool_slot_guard<pool> guard{p};
+    STATIC_PTR_RECORD(U, construct);
+    new (p) U(std::forward<Args>(args)...);
+    guard.release();
+    return p;
+  }
+
+ public:
+  pooled_ptr() = default;
+  ~pooled_ptr() {
+    destroy();
+  }
+
+  /// initializing constructor
+  template <typename U, typename ...Args>
+  pooled_ptr(in_place_t<U>, Args&&... args)
+    : slot(construct<U>(std::forward<Args>(args)...)),
+      operate(get_operate<U>()) {}
+
+  pooled_ptr(pooled_ptr&& o) noexcept
+    : slot(o.slot), operate(o.operate) {
+    o.slot = nullptr;
+    o.operate = nullptr;
+  }
+  pooled_ptr& operator=(pooled_ptr&& o)
+      noexcept(std::is_nothrow_destructible<T>::value) {
+    if (this != &o) {
+      destroy();
+      slot = o.slot;
+      operate = o.operate.get();
+      o.slot = nullptr;
+      o.operate = nullptr;
+    }
+    return *this;
+  }
+
+  /// converting move from a pointer to a derived type in the same pool
+  template <typename U, typename = typename std::enable_if<
+                std::is_base_of<T, U>::value>::type>
+  pooled_ptr(pooled_ptr<U, S, A>&& o) noexcept
+    : slot(o.slot), operate(o.operate.get()) {
+    static_assert(std::is_trivially_destructible<U>::value ||
+                  !std::is_trivially_destructible<T>::value,
+                  "move into pooled_ptr with incompatible type");
+    o.slot = nullptr;
+    o.operate = nullptr;
+  }
+
+  pooled_ptr(const pooled_ptr&) = delete;
+  pooled_ptr& operator=(const pooled_ptr&) = delete;
+
+  /// construct a new object in a new slot, then destroy the old one
+  template <typename U = T, typename ...Args>
+  void emplace(Args&&... args) {
+    void* p = construct<U>(std::forward<Args>(args)...);
+    destroy();
+    slot = p;
+    operate = get_operate<U>();
+  }
+
+  /// destruct an existing instance and return its slot to the pool
+  void reset() noexcept(std::is_nothrow_destructible<T>::value) {
+    destroy();
+  }
+
+  /// base pointer accessors
+  T* get() noexcept { return static_cast<T*>(slot); }
+  const T* get() const noexcept { return static_cast<const T*>(slot); }
+
+  T& operator*() noexcept { return *get(); }
+  const T& operator*() const noexcept { return *get(); }
+
+  T* operator->() noexcept { return get(); }
+  const T* operator->() const noexcept { return get(); }
+
+  operator bool() const noexcept { return slot != nullptr; }
+
+  /// member factory function
+  template <typename U = T, typename ...Args>
+  static pooled_ptr make(Args&&... args) {
+    return {in_place_t<U>{}, std::forward<Args>(args)...};
+  }
+};
+
+} // namespace static_ptr
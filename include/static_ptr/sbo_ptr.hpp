@@ -0,0 +1,295 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <cstddef>
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+namespace static_ptr {
+
+namespace _ {
+
+constexpr size_t max_size(size_t a, size_t b) { return a < b ? b : a; }
+
+/// allocation unit for spilled objects
+using sbo_unit = std::max_align_t;
+
+/// frees a spilled allocation unless released, for exception safety
+template <typename Alloc>
+class sbo_allocation_guard {
+  using alloc_traits = std::allocator_traits<Alloc>;
+  Alloc& alloc;
+  sbo_unit* p;
+  size_t n;
+ public:
+  sbo_allocation_guard(Alloc& alloc, sbo_unit* p, size_t n) noexcept
+    : alloc(alloc), p(p), n(n) {}
+  ~sbo_allocation_guard() {
+    if (p) {
+      alloc_traits::deallocate(alloc, p, n);
+    }
+  }
+  void release() noexcept { p = nullptr; }
+};
+
+} // namespace _
+
+/// a static_ptr with small buffer optimization: objects of type U that fit
+/// in the buffer are stored inline like static_ptr, and larger or
+/// over-aligned objects spill to memory from the allocator. the buffer holds
+/// the pointer to spilled objects, so moving them just steals the pointer
+template <typename T, size_t S = sizeof(T), typename Alloc = std::allocator<T>>
+class sbo_ptr : protected _::type_erasure_ops, _::deleted_ops<T>,
+                std::allocator_traits<Alloc>::template rebind_alloc<_::sbo_unit> {
+  using unit = _::sbo_unit;
+  using alloc_type = typename std::allocator_traits<Alloc>::template rebind_alloc<unit>;
+  using alloc_traits = std::allocator_traits<alloc_type>;
+
+  static constexpr size_t buffer_size = _::max_size(S, sizeof(void*));
+  static constexpr size_t buffer_align = _::max_size(alignof(T), alignof(void*));
+
+  /// inline storage for placement new, or the pointer to a spilled object
+  typename std::aligned_storage<buffer_size, buffer_align>::type buffer;
+
+  /// op table for the stored type, null while no object is constructed
+  op_storage<T> operate;
+
+  template <typename, size_t, typename> friend class sbo_ptr;
+
+  alloc_type& alloc() noexcept { return *this; }
+  const alloc_type& alloc() const noexcept { return *this; }
+
+  // allocators like std::pmr::polymorphic_allocator are not assignable, so
+  // only assign them when the propagate traits ask for it
+  void assign_alloc(const alloc_type& a, std::true_type) { alloc() = a; }
+  void assign_alloc(const alloc_type&, std::false_type) {}
+
+  static constexpr size_t units(size_t size) {
+    return (size + sizeof(unit) - 1) / sizeof(unit);
+  }
+
+  void*& heap() noexcept { return *reinterpret_cast<void**>(&buffer); }
+  void* heap() const noexcept { return *reinterpret_cast<void* const*>(&buffer); }
+
+  void* object() noexcept { return spilled() ? heap() : &buffer; }
+  const void* object() const noexcept { return spilled() ? heap() : &buffer; }
+
+  template <typename U, typename ...Args>
+  void construct(Args&&... args) {
+    static_assert(std::is_base_of<T, U>::value,
+                  "initializing with incompatible type");
+    static_assert(_::supports_same_ops<T, U>::value,
+                  "move into sbo_ptr with incompatible type");
+    using is_inline = std::integral_constant<bool, fits_inline<U>()>;
+    construct_in<U>(is_inline{}, std::forward<Args>(args)...);
+    operate = get_operate<U>();
+  }
+  template <typename U, typename ...Args>
+  void construct_in(std::true_type, Args&&... args) {
+    STATIC_PTR_RECORD(U, construct);
+    new (&buffer) U(std::forward<Args>(args)...);
+  }
+  template <typename U, typename ...Args>
+  void construct_in(std::false_type, Args&&... args) {
+    static_assert(alignof(U) <= alignof(unit),
+                  "spilled types can't be over-aligned");
+    const size_t n = units(sizeof(U));
+    unit* p = alloc_traits::allocate(alloc(), n);
+    _::sbo_allocation_guard<alloc_type> guard{alloc(), p, n};
+    STATIC_PTR_RECORD(U, construct);
+    new (p) U(std::forward<Args>(args)...);
+    guard.release();
+    heap() = p;
+  }
+
+  /// destruct the current object and free its memory, if any
+  void destroy() noexcept(std::is_nothrow_destructible<T>::value) {
+    if (operate) {
+      if (spilled()) {
+        destruct(heap(), operate);
+        alloc_traits::deallocate(alloc(), static_cast<unit*>(heap()),
+                                 units(operate->size));
+      } else {
+        destruct(&buffer, operate);
+      }
+      operate = nullptr;
+    }
+  }
+
+  /// move from another empty or engaged sbo_ptr into this empty one
+  void move_from(sbo_ptr& o, bool same_alloc) {
+    if (!o.operate) {
+      return;
+    }
+    if (!o.spilled()) {
+      move_construct<buffer_size>(&buffer, operate, &o.buffer, o.operate);
+    } else if (same_alloc) {
+      // steal the pointer
+      heap() = o.heap();
+      operate = o.operate.get();
+      o.operate = nullptr;
+    } else {
+      // relocate into memory from our allocator
+      const size_t n = units(o.operate->size);
+      unit* p = alloc_traits::allocate(alloc(), n);
+      _::sbo_allocation_guard<alloc_type> guard{alloc(), p, n};
+      if (auto relocate = o.operate->relocate) {
+        relocate(p, o.heap());
+      } else {
+        std::memcpy(p, o.heap(), o.operate->size);
+      }
+      guard.release();
+      alloc_traits::deallocate(o.alloc(), static_cast<unit*>(o.heap()), n);
+      heap() = p;
+      operate = o.operate.get();
+      o.operate = nullptr;
+    }
+  }
+
+  /// copy another sbo_ptr into this empty one
+  void copy_from(const sbo_ptr& o) {
+    if (!o.operate) {
+      return;
+    }
+    if (!o.spilled()) {
+      copy_construct<buffer_size>(&buffer, operate, &o.buffer, o.operate);
+      return;
+    }
+    const size_t n = units(o.operate->size);
+    unit* p = alloc_traits::allocate(alloc(), n);
+    _::sbo_allocation_guard<alloc_type> guard{alloc(), p, n};
+    if (auto copy_construct = o.operate->copy_construct) {
+      copy_construct(p, o.heap());
+    } else {
+      std::memcpy(p, o.heap(), o.operate->size);
+    }
+    guard.release();
+    heap() = p;
+    operate = o.operate.get();
+  }
+
+ public:
+  using allocator_type = Alloc;
+
+  /// whether objects of type U are stored inline instead of spilling
+  template <typename U>
+  static constexpr bool fits_inline() {
+    return sizeof(U) <= buffer_size && alignof(U) <= buffer_align;
+  }
+
+  sbo_ptr() = default;
+  explicit sbo_ptr(const Alloc& a) noexcept : alloc_type(a) {}
+  ~sbo_ptr() {
+    destroy();
+  }
+
+  /// initializing constructors
+  template <typename U, typename ...Args>
+  sbo_ptr(in_place_t<U>, Args&&... args) {
+    construct<U>(std::forward<Args>(args)...);
+  }
+  template <typename U, typename ...Args>
+  sbo_ptr(std::allocator_arg_t, const Alloc& a, in_place_t<U>, Args&&... args)
+    : alloc_type(a) {
+    construct<U>(std::forward<Args>(args)...);
+  }
+
+  /// in-place (re)initialization
+  template <typename U = T, typename ...Args>
+  void emplace(Args&&... args) {
+    reset();
+    construct<U>(std::forward<Args>(args)...);
+  }
+
+  // move operations
+  sbo_ptr(sbo_ptr&& o)
+      noexcept(is_trivially_relocatable<T>::value ||
+               _::relocater<T>::is_noexcept)
+    : alloc_type(std::move(o.alloc())) {
+    static_assert(_::move_constructer<T>::enabled,
+                  "must be MoveConstructible");
+    move_from(o, true);
+  }
+  sbo_ptr& operator=(sbo_ptr&& o) {
+    static_assert(_::move_assigner<T>::enabled,
+                  "must be MoveAssignable");
+    if (this != &o) {
+      destroy();
+      using propagate = typename
+          alloc_traits::propagate_on_container_move_assignment;
+      assign_alloc(o.alloc(), propagate{});
+      move_from(o, propagate::value || alloc() == o.alloc());
+    }
+    return *this;
+  }
+
+  // copy operations
+  sbo_ptr(const sbo_ptr& o)
+    : alloc_type(alloc_traits::select_on_container_copy_construction(o.alloc())) {
+    static_assert(_::copy_constructer<T>::enabled,
+                  "must be CopyConstructible");
+    copy_from(o);
+  }
+  sbo_ptr& operator=(const sbo_ptr& o) {
+    static_assert(_::copy_assigner<T>::enabled,
+                  "must be CopyAssignable");
+    if (this != &o) {
+      destroy();
+      assign_alloc(o.alloc(), typename
+          alloc_traits::propagate_on_container_copy_assignment{});
+      copy_from(o);
+    }
+    return *this;
+  }
+
+  /// destruct an existing instance
+  void reset() noexcept(std::is_nothrow_destructible<T>::value) {
+    destroy();
+  }
+
+  /// whether the current object was spilled to the allocator
+  bool spilled() const noexcept {
+    return operate && (operate->size > buffer_size ||
+                       operate->align > buffer_align);
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(alloc());
+  }
+
+  /// base pointer accessors
+  T* get() noexcept {
+    return operate ? reinterpret_cast<T*>(object()) : nullptr;
+  }
+  const T* get() const noexcept {
+    return operate ? reinterpret_cast<const T*>(object()) : nullptr;
+  }
+
+  T& operator*() noexcept { return *get(); }
+  const T& operator*() const noexcept { return *get(); }
+
+  T* operator->() noexcept { return get(); }
+  const T* operator->() const noexcept { return get(); }
+
+  operator bool() const noexcept { return static_cast<bool>(operate); }
+
+  /// member factory function
+  template <typename U = T, typename ...Args>
+  static sbo_ptr make(Args&&... args) {
+    return {in_place_t<U>{}, std::forward<Args>(args)...};
+  }
+};
+
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+namespace pmr {
+
+/// sbo_ptr that spills to a std::pmr::memory_resource
+template <typename T, size_t S = sizeof(T)>
+using sbo_ptr = ::static_ptr::sbo_ptr<T, S, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
+#endif
+
+} // namespace static_ptr
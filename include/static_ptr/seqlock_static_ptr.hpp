@@ -0,0 +1,145 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <atomic>
+#include <cstddef>
+
+namespace static_ptr {
+
+/// a static_ptr slot for publishing trivially copyable objects to many
+/// reader threads without locks. writers construct the new object aside and
+/// copy it into the slot under a sequence counter, and readers copy the slot
+/// into a local static_ptr, retrying if a write overlapped the copy. readers
+/// never block writers, and neither side allocates. concurrent writers are
+/// serialized by spinning on the sequence counter
+template <typename T, size_t S = sizeof(T), size_t A = alignof(T)>
+class seqlock_static_ptr {
+  static_assert(sizeof(T) <= S, "S is too small for T");
+  static_assert(std::is_trivially_copyable<T>::value,
+                "seqlock_static_ptr requires trivially copyable types");
+
+ public:
+  using static_ptr_type = static_ptr<T, S, A>;
+
+ private:
+  using op_fn = _::type_erasure_ops::op_fn;
+
+  /// the buffer is copied in words with relaxed atomic operations, so the
+  /// reads that overlap a write are races on atomics rather than data races
+  using word = std::size_t;
+  static constexpr size_t word_count = (S + sizeof(word) - 1) / sizeof(word);
+  /// A, or the alignment of the words if that's stricter. alignas can't
+  /// weaken their natural alignment
+  static constexpr size_t alignment = A > alignof(std::atomic<word>) ?
+      A : alignof(std::atomic<word>);
+
+  /// odd while a write is in progress
+  std::atomic<unsigned> seq{0};
+  /// op table for the published type, null while empty
+  std::atomic<op_fn> operate{nullptr};
+  alignas(alignment) std::atomic<word> words[word_count];
+
+  /// an aligned buffer of whole words, to copy to and from the slot
+  struct alignas(alignment) staging {
+    word words[word_count];
+  };
+
+  /// acquire the write side of the sequence counter
+  unsigned begin_write() noexcept {
+    unsigned s = seq.load(std::memory_order_relaxed);
+    for (;;) {
+      if (!(s & 1) && seq.compare_exchange_weak(s, s + 1,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+        break;
+      }
+      s = seq.load(std::memory_order_relaxed);
+    }
+    // order the counter increment before the writes of the payload
+    std::atomic_thread_fence(std::memory_order_release);
+    return s;
+  }
+
+  void publish(const staging& data, op_fn ops) noexcept {
+    const unsigned s = begin_write();
+    for (size_t i = 0; i < word_count; i++) {
+      words[i].store(data.words[i], std::memory_order_relaxed);
+    }
+    operate.store(ops, std::memory_order_relaxed);
+    seq.store(s + 2, std::memory_order_release);
+  }
+
+ public:
+  seqlock_static_ptr() noexcept {
+    for (auto& w : words) {
+      w.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  seqlock_static_ptr(const seqlock_static_ptr&) = delete;
+  seqlock_static_ptr& operator=(const seqlock_static_ptr&) = delete;
+
+  /// construct a U and publish it to readers
+  template <typename U = T, typename ...Args>
+  void emplace(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value) {
+    static_assert(sizeof(U) <= S,
+                  "size of type is larger than static size");
+    static_assert(alignof(U) <= A,
+                  "alignment of type is larger than static alignment");
+    static_assert(std::is_base_of<T, U>::value,
+                  "initializing with incompatible type");
+    static_assert(_::supports_same_ops<T, U>::value,
+                  "move into seqlock_static_ptr with incompatible type");
+    staging data{};
+    STATIC_PTR_RECORD(U, construct);
+    new (&data) U(std::forward<Args>(args)...);
+    publish(data, _::type_erasure_ops::get_operate<U>());
+  }
+
+  /// publish a copy of p's object, or the empty state
+  void store(const static_ptr_type& p) noexcept {
+    staging data{};
+    std::memcpy(&data, &p.buffer, S);
+    publish(data, p.operate.get());
+  }
+
+  /// publish the empty state
+  void reset() noexcept {
+    publish(staging{}, nullptr);
+  }
+
+  /// copy a consistent snapshot of the published object into out
+  void load(static_ptr_type& out) const noexcept {
+    staging data;
+    op_fn ops;
+    for (;;) {
+      const unsigned s1 = seq.load(std::memory_order_acquire);
+      if (s1 & 1) {
+        continue;
+      }
+      for (size_t i = 0; i < word_count; i++) {
+        data.words[i] = words[i].load(std::memory_order_relaxed);
+      }
+      ops = operate.load(std::memory_order_relaxed);
+      // order the payload reads before the second read of the counter
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq.load(std::memory_order_relaxed) == s1) {
+        break;
+      }
+    }
+    std::memcpy(&out.buffer, &data, S);
+    out.operate = ops;
+  }
+  static_ptr_type load() const noexcept {
+    static_ptr_type out;
+    load(out);
+    return out;
+  }
+};
+
+template <typename T, size_t S, size_t A>
+constexpr size_t seqlock_static_ptr<T, S, A>::word_count;
+
+} // namespace static_ptr
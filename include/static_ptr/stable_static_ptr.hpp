@@ -0,0 +1,227 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+/// the largest id that can be registered with stable_type_registry. the
+/// registry is a table indexed by id, so ids should be dense
+#ifndef STATIC_PTR_MAX_STABLE_TYPE_ID
+#define STATIC_PTR_MAX_STABLE_TYPE_ID 1023
+#endif
+
+namespace static_ptr {
+
+/// opt-in trait that assigns a type an id which is the same in every process
+/// and every build, to identify it in shared memory and files. specialize as
+/// std::integral_constant<std::uint32_t, N> with 0 < N <=
+/// STATIC_PTR_MAX_STABLE_TYPE_ID
+template <typename T>
+struct stable_type_id {};
+
+namespace _ {
+
+template <typename T, typename = void>
+struct has_stable_type_id : std::false_type {};
+template <typename T>
+struct has_stable_type_id<T, decltype(void(stable_type_id<T>::value))>
+    : std::true_type {};
+
+} // namespace _
+
+/// per-process table that maps stable type ids back to op tables. types are
+/// registered on first use by stable_static_ptr::emplace, and a process that
+/// only reads objects written elsewhere must add() their types itself.
+/// lookups are lock-free and never allocate
+class stable_type_registry {
+ public:
+  using id_type = std::uint32_t;
+  using op_fn = _::type_erasure_ops::op_fn;
+
+  static constexpr id_type max_id = STATIC_PTR_MAX_STABLE_TYPE_ID;
+
+  /// the stable id of U
+  template <typename U>
+  static constexpr id_type id_of() {
+    static_assert(_::has_stable_type_id<U>::value,
+                  "type has no stable_type_id specialization");
+    static_assert(stable_type_id<U>::value != 0 &&
+                  stable_type_id<U>::value <= max_id,
+                  "stable_type_id is out of range");
+    return stable_type_id<U>::value;
+  }
+
+  /// register each of Us. throws std::logic_error if another type was
+  /// already registered with the same id
+  template <typename ...Us>
+  static void add() {
+    int expand[] = {0, (add_one(id_of<Us>(),
+                                _::type_erasure_ops::get_operate<Us>()), 0)...};
+    (void)expand;
+  }
+
+  /// the op table registered for id, or null
+  static op_fn find(id_type id) noexcept {
+    if (id == 0 || id > max_id) {
+      return nullptr;
+    }
+    return table()[id].load(std::memory_order_acquire);
+  }
+
+ private:
+  static std::atomic<op_fn>* table() noexcept {
+    // zero-initialized before any dynamic initialization
+    static std::atomic<op_fn> ops[max_id + 1];
+    return ops;
+  }
+
+  static void add_one(id_type id, op_fn ops) {
+    op_fn expected = nullptr;
+    if (!table()[id].compare_exchange_strong(expected, ops,
+                                             std::memory_order_acq_rel) &&
+        expected != ops) {
+      _::throw_or_abort(
+          std::logic_error("stable_type_id registered for two types"));
+    }
+  }
+};
+
+/// a static_ptr that identifies the stored type by its stable_type_id rather
+/// than by the address of its op table, and resolves the op table through
+/// stable_type_registry. stored types must be trivially copyable, which
+/// also rules out virtual functions whose vtable pointers wouldn't survive a
+/// process boundary. stable_static_ptr is itself trivially copyable with a
+/// fixed layout of the id followed by the buffer, so arrays of them can be
+/// placed directly in shared memory or memory-mapped files and read by
+/// another process with no copy or fixup. use holds() or get_if() to
+/// recover the stored type. the whole object, including the padding after
+/// the id and the buffer, is zeroed on construction and before each
+/// emplace, so an object constructed in place in a file never leaks stale
+/// bytes. implicit copies aren't guaranteed to copy padding, so copy into
+/// shared memory with memcpy
+template <typename T, size_t S = sizeof(T), size_t A = alignof(T)>
+class stable_static_ptr {
+  static_assert(sizeof(T) <= S, "S is too small for T");
+  static_assert(A >= alignof(T), "A is too small for T");
+  static_assert(std::is_trivially_copyable<T>::value,
+                "stable_static_ptr requires trivially copyable types");
+
+ public:
+  using id_type = stable_type_registry::id_type;
+  using op_fn = stable_type_registry::op_fn;
+  using static_ptr_type = static_ptr<T, S, A>;
+
+ private:
+  /// stable id of the stored type, 0 while empty
+  id_type stored{0};
+  alignas(A) unsigned char buffer[S];
+
+  template <typename U>
+  static void check() {
+    static_assert(sizeof(U) <= S,
+                  "size of type is larger than static size");
+    static_assert(alignof(U) <= A,
+                  "alignment of type is larger than static alignment");
+    static_assert(std::is_base_of<T, U>::value,
+                  "initializing with incompatible type");
+    static_assert(std::is_trivially_copyable<U>::value,
+                  "stable_static_ptr requires trivially copyable types");
+  }
+
+  /// zero every byte of the object, including padding
+  void clear() noexcept {
+    std::memset(static_cast<void*>(this), 0, sizeof(*this));
+  }
+
+  /// register U the first time this process stores one
+  template <typename U>
+  static void register_type() {
+    static const bool registered = (stable_type_registry::add<U>(), true);
+    (void)registered;
+  }
+
+ public:
+  stable_static_ptr() noexcept { clear(); }
+
+  /// initializing constructor
+  template <typename U, typename ...Args>
+  explicit stable_static_ptr(in_place_t<U>, Args&&... args) {
+    emplace<U>(std::forward<Args>(args)...);
+  }
+
+  /// in-place (re)initialization
+  template <typename U = T, typename ...Args>
+  U& emplace(Args&&... args) {
+    check<U>();
+    register_type<U>();
+    clear();
+    STATIC_PTR_RECORD(U, construct);
+    auto u = new (buffer) U(std::forward<Args>(args)...);
+    stored = stable_type_registry::id_of<U>();
+    return *u;
+  }
+
+  void reset() noexcept { stored = 0; }
+
+  explicit operator bool() const noexcept { return stored != 0; }
+
+  /// stable id of the stored type, or 0 if empty
+  id_type id() const noexcept { return stored; }
+
+  /// op table of the stored type in this process, or null if empty or if
+  /// the id isn't registered here
+  op_fn type() const noexcept { return stable_type_registry::find(stored); }
+
+  /// whether the stored object can be used in this process: it's empty, or
+  /// its type is registered here and fits the buffer. worth checking on
+  /// objects read from untrusted memory before calling get()
+  bool valid() const noexcept {
+    if (!stored) {
+      return true;
+    }
+    const op_fn ops = type();
+    return ops && ops->size <= S && ops->align <= A;
+  }
+
+  /// whether the stored type is U
+  template <typename U>
+  bool holds() const noexcept {
+    return stored == stable_type_registry::id_of<U>();
+  }
+
+  /// pointer to the stored object if its type is U, otherwise null
+  template <typename U>
+  U* get_if() noexcept {
+    return holds<U>() ? reinterpret_cast<U*>(buffer) : nullptr;
+  }
+  template <typename U>
+  const U* get_if() const noexcept {
+    return holds<U>() ? reinterpret_cast<const U*>(buffer) : nullptr;
+  }
+
+  T* get() noexcept {
+    return stored ? reinterpret_cast<T*>(buffer) : nullptr;
+  }
+  const T* get() const noexcept {
+    return stored ? reinterpret_cast<const T*>(buffer) : nullptr;
+  }
+  T* operator->() noexcept { return get(); }
+  const T* operator->() const noexcept { return get(); }
+  T& operator*() noexcept { return *get(); }
+  const T& operator*() const noexcept { return *get(); }
+
+  /// copy the stored object into a static_ptr that uses this process's op
+  /// tables. the result is empty if the id isn't registered here
+  static_ptr_type load() const noexcept {
+    static_ptr_type out;
+    if (const op_fn ops = valid() ? type() : nullptr) {
+      std::memcpy(&out.buffer, buffer, S);
+      out.operate = ops;
+    }
+    return out;
+  }
+};
+
+} // namespace static_ptr
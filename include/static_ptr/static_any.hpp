@@ -0,0 +1,209 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <cstddef>
+#include <typeinfo>
+
+namespace static_ptr {
+
+namespace _ {
+
+/// stand-in for the unknown type stored in a static_any. its operations are
+/// all user-provided, so basic_static_ptr never takes the trivial fast paths
+/// and always dispatches through the op table of the stored type
+struct any_value {
+  any_value() noexcept {}
+  any_value(any_value&&) noexcept {}
+  any_value(const any_value&) {}
+  any_value& operator=(any_value&&) noexcept { return *this; }
+  any_value& operator=(const any_value&) { return *this; }
+  ~any_value() {}
+};
+
+} // namespace _
+
+/// exception thrown by the value-returning forms of any_cast on a type
+/// mismatch
+class bad_static_any_cast : public std::bad_cast {
+ public:
+  const char* what() const noexcept override { return "bad static_any cast"; }
+};
+
+/// a std::any that stores values of any type of size up to S and alignment
+/// up to A inline, and never allocates. the stored type is identified by
+/// its op table, so any_cast is a pointer comparison instead of a typeid
+/// lookup. stored types must be CopyConstructible and nothrow relocatable.
+/// copies use the same fallback as static_ptr, i.e. default construct +
+/// assign for types that can't be copy constructed. as with std::any,
+/// assignment never assigns the stored values, but destructs the current
+/// value and then relocates or copies the other
+template <size_t S, size_t A = alignof(std::max_align_t)>
+class static_any : public _::basic_static_ptr<_::any_value, S, A> {
+  using Base = _::basic_static_ptr<_::any_value, S, A>;
+  using Base::buffer;
+  using Base::destroy;
+  using Base::operate;
+  using Base::record_cross_type;
+
+  template <typename U>
+  static void check() {
+    static_assert(sizeof(U) <= S,
+                  "size of type is larger than static size");
+    static_assert(alignof(U) <= A,
+                  "alignment of type is larger than static alignment");
+    static_assert(_::copy_constructer<U>::enabled,
+                  "static_any requires CopyConstructible types");
+    static_assert(is_trivially_relocatable<U>::value ||
+                  _::relocater<U>::is_noexcept,
+                  "static_any requires nothrow relocation");
+  }
+
+  template <typename U>
+  struct is_in_place : std::false_type {};
+  template <typename U>
+  struct is_in_place<in_place_t<U>> : std::true_type {};
+
+ public:
+  using op_fn = _::type_erasure_ops::op_fn;
+
+  static_any() = default;
+  ~static_any() {
+    destroy();
+  }
+
+  static_any(static_any&&) = default;
+  static_any& operator=(static_any&& o) noexcept {
+    if (this != &o) {
+      record_cross_type(o.operate);
+      destroy();
+      this->template move_from<S>(&o.buffer, o.operate);
+    }
+    return *this;
+  }
+  static_any(const static_any&) = default;
+  /// copies o aside before destructing the current value, so that the value
+  /// is unchanged if the copy throws
+  static_any& operator=(const static_any& o) {
+    if (this != &o) {
+      *this = static_any(o);
+    }
+    return *this;
+  }
+
+  /// store a copy of value
+  template <typename U, typename D = typename std::decay<U>::type,
+            typename = typename std::enable_if<
+                !std::is_same<D, static_any>::value &&
+                !is_in_place<D>::value>::type>
+  static_any(U&& value)
+      noexcept(std::is_nothrow_constructible<D, U&&>::value)
+    : Base(Base::template get_operate<D>()) {
+    check<D>();
+    STATIC_PTR_RECORD(D, construct);
+    new (&buffer) D(std::forward<U>(value));
+  }
+
+  /// initializing constructor
+  template <typename U, typename ...Args>
+  explicit static_any(in_place_t<U>, Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value)
+    : Base(Base::template get_operate<U>()) {
+    check<U>();
+    STATIC_PTR_RECORD(U, construct);
+    new (&buffer) U(std::forward<Args>(args)...);
+  }
+
+  /// in-place (re)initialization
+  template <typename U, typename ...Args>
+  U& emplace(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value) {
+    check<U>();
+    destroy();
+    STATIC_PTR_RECORD(U, construct);
+    auto u = new (&buffer) U(std::forward<Args>(args)...);
+    operate = Base::template get_operate<U>();
+    return *u;
+  }
+
+  /// destruct an existing value
+  void reset() noexcept {
+    destroy();
+  }
+
+  /// exchange values with o by relocation
+  void swap(static_any& o) noexcept { this->swap_with(o); }
+  friend void swap(static_any& l, static_any& r) noexcept { l.swap(r); }
+
+  bool has_value() const noexcept { return static_cast<bool>(operate); }
+
+  /// identifies the stored type, as returned by get_operate<U>(), or null
+  op_fn type() const noexcept { return operate.get(); }
+
+  /// whether the stored type is U
+  template <typename U>
+  bool holds() const noexcept {
+    return operate.get() == Base::template get_operate<U>();
+  }
+
+  /// pointer to the stored value if its type is U, otherwise null
+  template <typename U>
+  U* get_if() noexcept {
+    return holds<U>() ? reinterpret_cast<U*>(&buffer) : nullptr;
+  }
+  template <typename U>
+  const U* get_if() const noexcept {
+    return holds<U>() ? reinterpret_cast<const U*>(&buffer) : nullptr;
+  }
+};
+
+/// pointer to the value of a if it holds a U, otherwise null
+template <typename U, size_t S, size_t A>
+U* any_cast(static_any<S, A>* a) noexcept
+{
+  return a ? a->template get_if<U>() : nullptr;
+}
+template <typename U, size_t S, size_t A>
+const U* any_cast(const static_any<S, A>* a) noexcept
+{
+  return a ? a->template get_if<U>() : nullptr;
+}
+
+/// the value of a converted to U, which may be a reference. throws
+/// bad_static_any_cast if a doesn't hold the decayed type of U, or calls the
+/// abort handler without exceptions
+template <typename U, size_t S, size_t A>
+U any_cast(static_any<S, A>& a)
+{
+  using D = typename std::remove_cv<
+      typename std::remove_reference<U>::type>::type;
+  auto p = any_cast<D>(&a);
+  if (!p) {
+    _::throw_or_abort(bad_static_any_cast());
+  }
+  return static_cast<U>(*p);
+}
+template <typename U, size_t S, size_t A>
+U any_cast(const static_any<S, A>& a)
+{
+  using D = typename std::remove_cv<
+      typename std::remove_reference<U>::type>::type;
+  auto p = any_cast<D>(&a);
+  if (!p) {
+    _::throw_or_abort(bad_static_any_cast());
+  }
+  return static_cast<U>(*p);
+}
+template <typename U, size_t S, size_t A>
+U any_cast(static_any<S, A>&& a)
+{
+  using D = typename std::remove_cv<
+      typename std::remove_reference<U>::type>::type;
+  auto p = any_cast<D>(&a);
+  if (!p) {
+    _::throw_or_abort(bad_static_any_cast());
+  }
+  return static_cast<U>(std::move(*p));
+}
+
+} // namespace static_ptr
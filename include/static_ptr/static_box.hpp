@@ -0,0 +1,236 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <utility>
+
+namespace static_ptr {
+
+namespace _ {
+
+/// static_box's move constructor leaves a default constructed T in the
+/// source, so it's only enabled for nothrow default constructible T
+template <typename T, bool = std::is_nothrow_default_constructible<T>::value &&
+                             std::is_move_constructible<T>::value>
+struct box_move_constructer {};
+template <typename T>
+struct box_move_constructer<T, false> {
+  box_move_constructer() = default;
+  box_move_constructer(box_move_constructer&&) = delete;
+  box_move_constructer& operator=(box_move_constructer&&) = default;
+  box_move_constructer(const box_move_constructer&) = default;
+  box_move_constructer& operator=(const box_move_constructer&) = default;
+};
+
+/// implementation of static_box with all move and copy operations
+template <typename T, size_t S, size_t A>
+class basic_static_box : protected type_erasure_ops {
+  static_assert(sizeof(T) <= S, "S is too small for T");
+  static_assert(A >= alignof(T), "A is too small for T");
+  static_assert(std::is_abstract<T>::value ||
+                is_trivially_relocatable<T>::value ||
+                relocater<T>::is_noexcept,
+                "static_box requires nothrow relocation");
+
+  using traits = basic_static_ptr<T, S, A>;
+
+  alignas(A) unsigned char buffer[S];
+
+  /// op table for the stored type, never null
+  op_storage<T> operate;
+
+  /// relocate an object with the given ops from src to dst
+  static void relocate(void* dst, void* src, op_fn ops) noexcept {
+    if (!traits::trivial_relocate) {
+      if (auto relocate = ops->relocate) {
+        relocate(dst, src);
+        return;
+      }
+    }
+    std::memcpy(dst, src, S);
+  }
+
+  void destroy() noexcept(std::is_nothrow_destructible<T>::value) {
+    if (!traits::trivial_destruct) {
+      destruct(buffer, operate);
+    }
+  }
+
+  /// copy the object of o into this buffer, which holds no object
+  void copy_from(const basic_static_box& o) {
+    if (!traits::trivial_copy) {
+      if (auto copy_construct = o.operate->copy_construct) {
+        copy_construct(buffer, o.buffer);
+        return;
+      }
+    }
+    std::memcpy(buffer, o.buffer, S);
+  }
+
+  /// replace the object in place when construction can't throw
+  template <typename U, typename ...Args>
+  void replace(std::true_type, Args&&... args) noexcept {
+    destroy();
+    STATIC_PTR_RECORD(U, construct);
+    new (buffer) U(std::forward<Args>(args)...);
+    operate = get_operate<U>();
+  }
+  /// otherwise construct it aside, so the box still holds the old object if
+  /// construction throws
+  template <typename U, typename ...Args>
+  void replace(std::false_type, Args&&... args) {
+    alignas(A) unsigned char tmp[S];
+    STATIC_PTR_RECORD(U, construct);
+    new (tmp) U(std::forward<Args>(args)...);
+    destroy();
+    relocate(buffer, tmp, get_operate<U>());
+    operate = get_operate<U>();
+  }
+
+ public:
+  /// initializing constructor
+  template <typename U, typename ...Args>
+  basic_static_box(in_place_t<U>, Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value)
+    : operate(get_operate<U>()) {
+    static_assert(sizeof(U) <= S,
+                  "size of type is larger than static size");
+    static_assert(alignof(U) <= A,
+                  "alignment of type is larger than static alignment");
+    static_assert(std::is_base_of<T, U>::value,
+                  "initializing with incompatible type");
+    static_assert(supports_same_ops<T, U>::value,
+                  "move into static_box with incompatible type");
+    static_assert(is_trivially_relocatable<U>::value ||
+                  relocater<U>::is_noexcept,
+                  "static_box requires nothrow relocation");
+    STATIC_PTR_RECORD(U, construct);
+    new (buffer) U(std::forward<Args>(args)...);
+  }
+  ~basic_static_box() {
+    destroy();
+  }
+
+  /// relocate the object of o, and leave a default constructed T in its place
+  basic_static_box(basic_static_box&& o)
+      noexcept(std::is_nothrow_default_constructible<T>::value)
+    : operate(o.operate) {
+    relocate(buffer, o.buffer, o.operate.get());
+    new (o.buffer) T();
+    o.operate = get_operate<T>();
+  }
+  /// move assignment swaps, so the source holds the previous object
+  basic_static_box& operator=(basic_static_box&& o) noexcept {
+    swap(o);
+    return *this;
+  }
+
+  basic_static_box(const basic_static_box& o)
+      noexcept(std::is_trivially_copyable<T>::value ||
+               copy_constructer<T>::is_noexcept)
+    : operate(o.operate) {
+    copy_from(o);
+  }
+  basic_static_box& operator=(const basic_static_box& o)
+      noexcept(std::is_trivially_copyable<T>::value ||
+               (copy_constructer<T>::is_noexcept &&
+                copy_assigner<T>::is_noexcept)) {
+    if (this == &o) {
+      return *this;
+    }
+    if (operate.get() == o.operate.get()) {
+      // same type, copy assign
+      if (traits::trivial_copy || !o.operate->copy_assign) {
+        std::memcpy(buffer, o.buffer, S);
+      } else {
+        o.operate->copy_assign(buffer, o.buffer);
+      }
+      return *this;
+    }
+    // copy aside, so the box still holds the old object if the copy throws
+    basic_static_box tmp{o};
+    swap(tmp);
+    return *this;
+  }
+
+  /// exchange objects by relocating through a temporary buffer
+  void swap(basic_static_box& o) noexcept {
+    if (this == &o) {
+      return;
+    }
+    alignas(A) unsigned char tmp[S];
+    relocate(tmp, buffer, operate.get());
+    relocate(buffer, o.buffer, o.operate.get());
+    relocate(o.buffer, tmp, operate.get());
+    std::swap(operate, o.operate);
+  }
+  friend void swap(basic_static_box& l, basic_static_box& r) noexcept {
+    l.swap(r);
+  }
+
+  /// in-place reinitialization. the box keeps its old object if the
+  /// construction throws
+  template <typename U = T, typename ...Args>
+  void emplace(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value &&
+               std::is_nothrow_destructible<T>::value) {
+    static_assert(sizeof(U) <= S,
+                  "size of type is larger than static size");
+    static_assert(alignof(U) <= A,
+                  "alignment of type is larger than static alignment");
+    static_assert(std::is_base_of<T, U>::value,
+                  "initializing with incompatible type");
+    static_assert(supports_same_ops<T, U>::value,
+                  "move into static_box with incompatible type");
+    static_assert(is_trivially_relocatable<U>::value ||
+                  relocater<U>::is_noexcept,
+                  "static_box requires nothrow relocation");
+    replace<U>(std::integral_constant<bool,
+        std::is_nothrow_constructible<U, Args&&...>::value>{},
+        std::forward<Args>(args)...);
+  }
+
+  /// identifies the dynamic type, as returned by get_operate<U>()
+  op_fn type() const noexcept { return operate.get(); }
+
+  /// base pointer accessors, which never return null
+  T* get() noexcept { return reinterpret_cast<T*>(buffer); }
+  const T* get() const noexcept { return reinterpret_cast<const T*>(buffer); }
+
+  T& operator*() noexcept { return *get(); }
+  const T& operator*() const noexcept { return *get(); }
+
+  T* operator->() noexcept { return get(); }
+  const T* operator->() const noexcept { return get(); }
+};
+
+} // namespace _
+
+/// a non-nullable static_ptr, for hot objects that are always engaged. it
+/// must be constructed with a value, and has no reset(), so get() and
+/// operator-> never branch on an empty state. moves never leave the source
+/// empty: move assignment swaps, and move construction relocates the object
+/// and constructs a T in the source, so it's only available when T is nothrow
+/// default constructible. objects must be nothrow relocatable, and since
+/// swapping is all that's needed, an abstract T still supports move assignment
+template <typename T, size_t S = sizeof(T), size_t A = alignof(T)>
+class static_box : public _::basic_static_box<T, S, A>,
+                   _::box_move_constructer<T>,
+                   _::copy_constructer<T>, _::copy_assigner<T> {
+  using Base = _::basic_static_box<T, S, A>;
+ public:
+  /// initializing constructor
+  template <typename U, typename ...Args>
+  static_box(in_place_t<U>, Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value)
+    : Base(in_place_t<U>{}, std::forward<Args>(args)...) {}
+
+  /// member factory function
+  template <typename U = T, typename ...Args>
+  static static_box make(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value) {
+    return {in_place_t<U>{}, std::forward<Args>(args)...};
+  }
+};
+
+} // namespace static_ptr
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <cstddef>
+#include <functional>
+
+namespace static_ptr {
+
+namespace _ {
+
+/// call f, converting its result to R, or discarding it if R is void
+template <typename R, typename F, typename ...Args>
+typename std::enable_if<!std::is_void<R>::value, R>::type
+invoke_r(F& f, Args&&... args) {
+  return f(std::forward<Args>(args)...);
+}
+template <typename R, typename F, typename ...Args>
+typename std::enable_if<std::is_void<R>::value>::type
+invoke_r(F& f, Args&&... args) {
+  f(std::forward<Args>(args)...);
+}
+
+/// whether an lvalue of type F can be called with Args, and its result
+/// converted to R or discarded if R is void
+template <typename R, typename F, typename ...Args>
+struct is_invocable_r {
+  template <typename G, typename Result = decltype(
+                std::declval<G&>()(std::declval<Args>()...))>
+  static std::integral_constant<bool, std::is_void<R>::value ||
+                                std::is_convertible<Result, R>::value>
+  test(int);
+  template <typename G>
+  static std::false_type test(...);
+
+  static constexpr bool value = decltype(test<F>(0))::value;
+};
+
+/// base class that disables the copy operations of a move-only wrapper
+struct move_only {
+  move_only() = default;
+  move_only(move_only&&) = default;
+  move_only& operator=(move_only&&) = default;
+  move_only(const move_only&) = delete;
+  move_only& operator=(const move_only&) = delete;
+};
+
+template <typename Sig, size_t S, bool Copyable, bool Noexcept>
+class basic_static_function;
+
+/// implementation of static_function with all move and copy operations
+template <typename R, typename ...Args, size_t S, bool Copyable, bool Noexcept>
+class basic_static_function<R(Args...), S, Copyable, Noexcept>
+    : protected type_erasure_ops {
+ public:
+  /// alignment of the buffer
+  static constexpr size_t alignment = alignof(std::max_align_t);
+
+ private:
+  using invoke_fn = R (*)(void*, Args&&...);
+
+  template <typename F>
+  static R invoke(void* f, Args&&... args) {
+    return invoke_r<R>(*static_cast<F*>(f), std::forward<Args>(args)...);
+  }
+  static R invoke_empty(void*, Args&&...) {
+    _::throw_or_abort(std::bad_function_call());
+  }
+
+  alignas(alignment) unsigned char buffer[S];
+  /// calls the stored callable, or throws bad_function_call while empty (calls
+  /// the abort handler without exceptions), so operator() is a single
+  /// indirect call without a test for empty
+  invoke_fn invoker{&invoke_empty};
+  /// op table for the stored callable, null while empty
+  op_fn operate{nullptr};
+
+  void destroy() noexcept {
+    if (operate) {
+      destruct(buffer, operate);
+      operate = nullptr;
+      invoker = &invoke_empty;
+    }
+  }
+
+  void move_from(basic_static_function& o) noexcept {
+    if (o.operate) {
+      if (auto relocate = o.operate->relocate) {
+        relocate(buffer, o.buffer);
+      } else {
+        std::memcpy(buffer, o.buffer, S);
+      }
+      operate = o.operate;
+      invoker = o.invoker;
+      o.operate = nullptr;
+      o.invoker = &invoke_empty;
+    }
+  }
+
+  void copy_from(const basic_static_function& o) {
+    if (o.operate) {
+      if (auto copy_construct = o.operate->copy_construct) {
+        copy_construct(buffer, o.buffer);
+      } else {
+        std::memcpy(buffer, o.buffer, S);
+      }
+      operate = o.operate;
+      invoker = o.invoker;
+    }
+  }
+
+ public:
+  using result_type = R;
+
+  /// whether a callable of type F can be stored
+  template <typename F, typename D = typename std::decay<F>::type>
+  static constexpr bool fits() {
+    return sizeof(D) <= S && alignof(D) <= alignment;
+  }
+
+  basic_static_function() = default;
+  basic_static_function(std::nullptr_t) noexcept {}
+
+  /// store a copy of the callable f, which must be invocable with Args and
+  /// return a result convertible to R
+  template <typename F, typename D = typename std::decay<F>::type,
+            typename = typename std::enable_if<
+                !std::is_base_of<basic_static_function, D>::value &&
+                is_invocable_r<R, D, Args...>::value>::type>
+  basic_static_function(F&& f)
+      noexcept(std::is_nothrow_constructible<D, F&&>::value) {
+    static_assert(sizeof(D) <= S,
+                  "size of callable is larger than static size");
+    static_assert(alignof(D) <= alignment,
+                  "alignment of callable is larger than static alignment");
+    static_assert(!Copyable || std::is_copy_constructible<D>::value,
+                  "callable must be CopyConstructible");
+    static_assert(!Noexcept ||
+                  noexcept(std::declval<D&>()(std::declval<Args>()...)),
+                  "callable must be nothrow invocable");
+    static_assert(is_trivially_relocatable<D>::value ||
+                  relocater<D>::is_noexcept,
+                  "static_function requires nothrow relocation");
+    STATIC_PTR_RECORD(D, construct);
+    new (buffer) D(std::forward<F>(f));
+    operate = get_operate<D>();
+    invoker = &invoke<D>;
+  }
+
+  ~basic_static_function() {
+    destroy();
+  }
+
+  basic_static_function(basic_static_function&& o) noexcept {
+    move_from(o);
+  }
+  basic_static_function& operator=(basic_static_function&& o) noexcept {
+    if (this != &o) {
+      destroy();
+      move_from(o);
+    }
+    return *this;
+  }
+
+  basic_static_function(const basic_static_function& o) {
+    copy_from(o);
+  }
+  basic_static_function& operator=(const basic_static_function& o) {
+    if (this != &o) {
+      // copy aside, so this is unchanged if the copy throws
+      basic_static_function tmp{o};
+      destroy();
+      move_from(tmp);
+    }
+    return *this;
+  }
+
+  basic_static_function& operator=(std::nullptr_t) noexcept {
+    destroy();
+    return *this;
+  }
+
+  R operator()(Args... args) const noexcept(Noexcept) {
+    return invoker(const_cast<unsigned char*>(buffer),
+                   std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const noexcept { return operate != nullptr; }
+};
+
+template <typename R, typename ...Args, size_t S, bool Copyable, bool Noexcept>
+constexpr size_t
+basic_static_function<R(Args...), S, Copyable, Noexcept>::alignment;
+
+} // namespace _
+
+/// a copyable replacement for std::function that stores callables of size up
+/// to S inline and never allocates. operator() is a single indirect call.
+/// with Noexcept, operator() is noexcept and only accepts callables that are
+/// nothrow invocable, like std::function<R(Args...) noexcept> would
+template <typename Sig, size_t S, bool Noexcept = false>
+class static_function
+    : public _::basic_static_function<Sig, S, true, Noexcept> {
+  using Base = _::basic_static_function<Sig, S, true, Noexcept>;
+ public:
+  using Base::Base;
+  static_function() = default;
+};
+
+/// a static_function that also accepts move-only callables, and is itself
+/// move-only
+template <typename Sig, size_t S, bool Noexcept = false>
+class move_only_static_function
+    : public _::basic_static_function<Sig, S, false, Noexcept>, _::move_only {
+  using Base = _::basic_static_function<Sig, S, false, Noexcept>;
+ public:
+  using Base::Base;
+  move_only_static_function() = default;
+};
+
+} // namespace static_ptr
@@ -1,7 +1,71 @@
 #pragma once
 
+#include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
+
+#include <static_ptr/abort_handler.hpp>
+
+// c++20 adds constant initialization of static_ptrs that hold trivially
+// copyable literal types, i.e. constinit globals. c++11 is unaffected
+#if __cplusplus >= 202002L
+#include <array>
+#include <bit>
+#if defined(__cpp_lib_bit_cast) && defined(__cpp_lib_is_constant_evaluated)
+#define STATIC_PTR_HAS_CONSTEXPR 1
+#endif
+#endif
+
+#ifdef STATIC_PTR_HAS_CONSTEXPR
+#define STATIC_PTR_CONSTEXPR20 constexpr
+#else
+#define STATIC_PTR_CONSTEXPR20
+#endif
+
+// type traits evaluated through compiler builtins where available, which is
+// much cheaper to compile than instantiating the standard trait templates
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 11)
+#define STATIC_PTR_IS_CONSTRUCTIBLE(...) __is_constructible(__VA_ARGS__)
+#define STATIC_PTR_IS_NOTHROW_CONSTRUCTIBLE(...) \
+  __is_nothrow_constructible(__VA_ARGS__)
+#define STATIC_PTR_IS_ASSIGNABLE(T, U) __is_assignable(T, U)
+#define STATIC_PTR_IS_NOTHROW_ASSIGNABLE(T, U) __is_nothrow_assignable(T, U)
+#define STATIC_PTR_IS_TRIVIALLY_COPYABLE(T) __is_trivially_copyable(T)
+#ifdef __clang__
+#define STATIC_PTR_HAS_TRIVIAL_DESTRUCTOR(T) __is_trivially_destructible(T)
+#else
+#define STATIC_PTR_HAS_TRIVIAL_DESTRUCTOR(T) __has_trivial_destructor(T)
+#endif
+#else
+#define STATIC_PTR_IS_CONSTRUCTIBLE(...) \
+  std::is_constructible<__VA_ARGS__>::value
+#define STATIC_PTR_IS_NOTHROW_CONSTRUCTIBLE(...) \
+  std::is_nothrow_constructible<__VA_ARGS__>::value
+#define STATIC_PTR_IS_ASSIGNABLE(T, U) std::is_assignable<T, U>::value
+#define STATIC_PTR_IS_NOTHROW_ASSIGNABLE(T, U) \
+  std::is_nothrow_assignable<T, U>::value
+#define STATIC_PTR_IS_TRIVIALLY_COPYABLE(T) std::is_trivially_copyable<T>::value
+#define STATIC_PTR_HAS_TRIVIAL_DESTRUCTOR(T) \
+  std::is_trivially_destructible<T>::value
+#endif
+
+// count an op_event for type T, or for the type of an op table
+#ifdef STATIC_PTR_ENABLE_OP_STATS
+#include <static_ptr/op_stats.hpp>
+#define STATIC_PTR_RECORD(T, event) \
+  ::static_ptr::op_stats::record<T>(::static_ptr::op_event::event)
+#define STATIC_PTR_RECORD_OPS(ops, event) \
+  ::static_ptr::op_stats::record(*(ops)->stats, ::static_ptr::op_event::event)
+#else
+#define STATIC_PTR_RECORD(T, event) ((void)0)
+#define STATIC_PTR_RECORD_OPS(ops, event) ((void)0)
+#endif
+
+#ifdef STATIC_PTR_ENABLE_LAYOUT_STATS
+#include <static_ptr/layout_stats.hpp>
+#endif
 
 namespace static_ptr {
 
@@ -9,17 +73,85 @@ namespace static_ptr {
 template <typename>
 struct in_place_t {};
 
+/// trait for types whose objects can be moved to a new address by copying
+/// their bytes, without running the move constructor and destructor. defaults
+/// to whether T is trivially copyable; specialize as std::true_type for other
+/// types that are known to be bitwise-relocatable. static_ptr moves these
+/// types with memcpy instead of calling through the type-erased operations
+template <typename T>
+struct is_trivially_relocatable
+    : std::integral_constant<bool, STATIC_PTR_IS_TRIVIALLY_COPYABLE(T)> {};
+
 namespace _ {
 
+/// operations that a type supports, as bits of the mask in capabilities
+enum capability : unsigned {
+  cap_default_construct = 1u << 0,
+  cap_nothrow_default_construct = 1u << 1,
+  cap_move_construct = 1u << 2,
+  cap_nothrow_move_construct = 1u << 3,
+  cap_move_assign = 1u << 4,
+  cap_nothrow_move_assign = 1u << 5,
+  cap_copy_construct = 1u << 6,
+  cap_nothrow_copy_construct = 1u << 7,
+  cap_copy_assign = 1u << 8,
+  cap_nothrow_copy_assign = 1u << 9,
+  cap_destruct = 1u << 10,
+  cap_nothrow_destruct = 1u << 11,
+  cap_trivially_destructible = 1u << 12,
+  cap_trivially_copyable = 1u << 13,
+  cap_trivially_relocatable = 1u << 14,
+};
+
+constexpr unsigned cap_if(bool b, capability c) { return b ? c : 0u; }
+
+/// cap_destruct and cap_nothrow_destruct, without the cost of
+/// std::is_destructible
+template <typename T, typename = decltype(std::declval<T&>().~T())>
+constexpr unsigned destruct_caps(int) {
+  return cap_destruct |
+      cap_if(noexcept(std::declval<T&>().~T()), cap_nothrow_destruct);
+}
+template <typename T>
+constexpr unsigned destruct_caps(...) { return 0u; }
+
+/// mask of the capabilities of T. every trait below reads this mask instead
+/// of evaluating the standard traits itself, so each type's traits are
+/// evaluated once rather than once per helper or per pair of types
+template <typename T>
+struct capabilities : std::integral_constant<unsigned, destruct_caps<T>(0) |
+    cap_if(STATIC_PTR_IS_CONSTRUCTIBLE(T), cap_default_construct) |
+    cap_if(STATIC_PTR_IS_NOTHROW_CONSTRUCTIBLE(T),
+           cap_nothrow_default_construct) |
+    cap_if(STATIC_PTR_IS_CONSTRUCTIBLE(T, T&&), cap_move_construct) |
+    cap_if(STATIC_PTR_IS_NOTHROW_CONSTRUCTIBLE(T, T&&),
+           cap_nothrow_move_construct) |
+    cap_if(STATIC_PTR_IS_ASSIGNABLE(T&, T&&), cap_move_assign) |
+    cap_if(STATIC_PTR_IS_NOTHROW_ASSIGNABLE(T&, T&&), cap_nothrow_move_assign) |
+    cap_if(STATIC_PTR_IS_CONSTRUCTIBLE(T, const T&), cap_copy_construct) |
+    cap_if(STATIC_PTR_IS_NOTHROW_CONSTRUCTIBLE(T, const T&),
+           cap_nothrow_copy_construct) |
+    cap_if(STATIC_PTR_IS_ASSIGNABLE(T&, const T&), cap_copy_assign) |
+    cap_if(STATIC_PTR_IS_NOTHROW_ASSIGNABLE(T&, const T&),
+           cap_nothrow_copy_assign) |
+    cap_if((destruct_caps<T>(0) & cap_destruct) &&
+           STATIC_PTR_HAS_TRIVIAL_DESTRUCTOR(T),
+           cap_trivially_destructible) |
+    cap_if(STATIC_PTR_IS_TRIVIALLY_COPYABLE(T), cap_trivially_copyable) |
+    cap_if(is_trivially_relocatable<T>::value, cap_trivially_relocatable)> {};
+
+/// whether T has all of the capabilities in mask
+template <typename T>
+constexpr bool has_caps(unsigned mask) {
+  return (capabilities<T>::value & mask) == mask;
+}
+
 // template specializations for move and copy operations
 template <typename T, bool CanMoveConstruct,
           bool CanDefaultConstruct, bool CanMoveAssign>
 struct move_constructer_impl {
   static constexpr bool enabled{false};
   static constexpr bool is_noexcept{false};
-  static void call(T* lhs, T* rhs) {
-    throw std::logic_error("move constructor disabled");
-  }
   move_constructer_impl() = default;
   move_constructer_impl(move_constructer_impl&&) = delete;
   move_constructer_impl& operator=(move_constructer_impl&&) = default;
@@ -29,7 +161,7 @@ struct move_constructer_impl {
 template <typename T, bool CanDefaultConstruct, bool CanMoveAssign>
 struct move_constructer_impl<T, true, CanDefaultConstruct, CanMoveAssign> {
   static constexpr bool enabled{true};
-  static constexpr bool is_noexcept = std::is_nothrow_move_constructible<T>::value;
+  static constexpr bool is_noexcept = has_caps<T>(cap_nothrow_move_construct);
   static void call(T* lhs, T* rhs) noexcept(is_noexcept) {
     new (lhs) T(std::move(*rhs));
   }
@@ -38,9 +170,10 @@ struct move_constructer_impl<T, true, CanDefaultConstruct, CanMoveAssign> {
 template <typename T>
 struct move_constructer_impl<T, false, true, true> {
   static constexpr bool enabled{true};
-  static constexpr bool is_noexcept = std::is_nothrow_default_constructible<T>::value &&
-      std::is_nothrow_move_assignable<T>::value;
+  static constexpr bool is_noexcept = has_caps<T>(
+      cap_nothrow_default_construct | cap_nothrow_move_assign);
   static void call(T* lhs, T* rhs) noexcept(is_noexcept) {
+    STATIC_PTR_RECORD(T, move_construct_fallback);
     new (lhs) T();
     *lhs = std::move(*rhs);
   }
@@ -48,17 +181,14 @@ struct move_constructer_impl<T, false, true, true> {
 
 template <typename T, typename DecayT = typename std::decay<T>::type>
 using move_constructer = move_constructer_impl<DecayT,
-      std::is_move_constructible<DecayT>::value,
-      std::is_move_assignable<DecayT>::value,
-      std::is_default_constructible<DecayT>::value>;
+      has_caps<DecayT>(cap_move_construct),
+      has_caps<DecayT>(cap_move_assign),
+      has_caps<DecayT>(cap_default_construct)>;
 
 template <typename T, bool CanMoveAssign, bool CanMoveConstruct>
 struct move_assigner_impl {
   static constexpr bool enabled{false};
   static constexpr bool is_noexcept{false};
-  static void call(T* lhs, T* rhs) {
-    throw std::logic_error("move assignment disabled");
-  }
   move_assigner_impl() = default;
   move_assigner_impl(move_assigner_impl&&) = default;
   move_assigner_impl& operator=(move_assigner_impl&&) = delete;
@@ -68,7 +198,7 @@ struct move_assigner_impl {
 template <typename T, bool CanMoveConstruct>
 struct move_assigner_impl<T, true, CanMoveConstruct> {
   static constexpr bool enabled{true};
-  static constexpr bool is_noexcept = std::is_nothrow_move_assignable<T>::value;
+  static constexpr bool is_noexcept = has_caps<T>(cap_nothrow_move_assign);
   static void call(T* lhs, T* rhs) noexcept(is_noexcept) {
     *lhs = std::move(*rhs);
   }
@@ -77,9 +207,10 @@ struct move_assigner_impl<T, true, CanMoveConstruct> {
 template <typename T>
 struct move_assigner_impl<T, false, true> {
   static constexpr bool enabled{true};
-  static constexpr bool is_noexcept = std::is_nothrow_destructible<T>::value &&
-      std::is_nothrow_move_constructible<T>::value;
+  static constexpr bool is_noexcept = has_caps<T>(
+      cap_nothrow_destruct | cap_nothrow_move_construct);
   static void call(T* lhs, T* rhs) noexcept(is_noexcept) {
+    STATIC_PTR_RECORD(T, move_assign_fallback);
     lhs->~T();
     new (lhs) T(std::move(*rhs));
   }
@@ -87,17 +218,14 @@ struct move_assigner_impl<T, false, true> {
 
 template <typename T, typename DecayT = typename std::decay<T>::type>
 using move_assigner = move_assigner_impl<DecayT,
-      std::is_move_assignable<DecayT>::value,
-      std::is_move_constructible<DecayT>::value>;
+      has_caps<DecayT>(cap_move_assign),
+      has_caps<DecayT>(cap_move_construct)>;
 
 template <typename T, bool CanCopyConstruct,
           bool CanDefaultConstruct, bool CanCopyAssign>
 struct copy_constructer_impl {
   static constexpr bool enabled{false};
   static constexpr bool is_noexcept{false};
-  static void call(T* lhs, const T* rhs) {
-    throw std::logic_error("copy constructor disabled");
-  }
   copy_constructer_impl() = default;
   copy_constructer_impl(copy_constructer_impl&&) = default;
   copy_constructer_impl& operator=(copy_constructer_impl&&) = default;
@@ -107,7 +235,7 @@ struct copy_constructer_impl {
 template <typename T, bool CanDefaultConstruct, bool CanCopyAssign>
 struct copy_constructer_impl<T, true, CanDefaultConstruct, CanCopyAssign> {
   static constexpr bool enabled{true};
-  static constexpr bool is_noexcept = std::is_nothrow_copy_constructible<T>::value;
+  static constexpr bool is_noexcept = has_caps<T>(cap_nothrow_copy_construct);
   static void call(T* lhs, const T* rhs) noexcept(is_noexcept) {
     new (lhs) T(*rhs);
   }
@@ -116,9 +244,10 @@ struct copy_constructer_impl<T, true, CanDefaultConstruct, CanCopyAssign> {
 template <typename T>
 struct copy_constructer_impl<T, false, true, true> {
   static constexpr bool enabled{true};
-  static constexpr bool is_noexcept = std::is_nothrow_default_constructible<T>::value &&
-      std::is_nothrow_copy_assignable<T>::value;
-  static void call(T* lhs, T* rhs) noexcept(is_noexcept) {
+  static constexpr bool is_noexcept = has_caps<T>(
+      cap_nothrow_default_construct | cap_nothrow_copy_assign);
+  static void call(T* lhs, const T* rhs) noexcept(is_noexcept) {
+    STATIC_PTR_RECORD(T, copy_construct_fallback);
     new (lhs) T();
     *lhs = *rhs;
   }
@@ -126,17 +255,14 @@ struct copy_constructer_impl<T, false, true, true> {
 
 template <typename T, typename DecayT = typename std::decay<T>::type>
 using copy_constructer = copy_constructer_impl<DecayT,
-      std::is_copy_constructible<DecayT>::value,
-      std::is_copy_assignable<DecayT>::value,
-      std::is_default_constructible<DecayT>::value>;
+      has_caps<DecayT>(cap_copy_construct),
+      has_caps<DecayT>(cap_copy_assign),
+      has_caps<DecayT>(cap_default_construct)>;
 
 template <typename T, bool CanCopyAssign>
 struct copy_assigner_impl {
   static constexpr bool enabled{false};
   static constexpr bool is_noexcept{false};
-  static void call(T* lhs, const T* rhs) {
-    throw std::logic_error("copy assignment disabled");
-  }
   copy_assigner_impl() = default;
   copy_assigner_impl(copy_assigner_impl&&) = default;
   copy_assigner_impl& operator=(copy_assigner_impl&&) = default;
@@ -146,7 +272,7 @@ struct copy_assigner_impl {
 template <typename T>
 struct copy_assigner_impl<T, true> {
   static constexpr bool enabled{true};
-  static constexpr bool is_noexcept = std::is_nothrow_copy_assignable<T>::value;
+  static constexpr bool is_noexcept = has_caps<T>(cap_nothrow_copy_assign);
   static void call(T* lhs, const T* rhs) noexcept(is_noexcept) {
     *lhs = *rhs;
   }
@@ -154,7 +280,32 @@ struct copy_assigner_impl<T, true> {
 
 template <typename T, typename DecayT = typename std::decay<T>::type>
 using copy_assigner = copy_assigner_impl<DecayT,
-      std::is_copy_assignable<DecayT>::value>;
+      has_caps<DecayT>(cap_copy_assign)>;
+
+/// fused move construct + destruct of the source, so that moving an object
+/// to a new buffer takes a single type-erased call
+template <typename T>
+struct relocater {
+  static constexpr bool enabled{move_constructer<T>::enabled};
+  static constexpr bool is_noexcept = move_constructer<T>::is_noexcept &&
+      has_caps<T>(cap_nothrow_destruct);
+  static void call(T* lhs, T* rhs) noexcept(is_noexcept) {
+    move_constructer<T>::call(lhs, rhs);
+    rhs->~T();
+  }
+};
+
+/// fused move assign + destruct of the source
+template <typename T>
+struct relocate_assigner {
+  static constexpr bool enabled{move_assigner<T>::enabled};
+  static constexpr bool is_noexcept = move_assigner<T>::is_noexcept &&
+      has_caps<T>(cap_nothrow_destruct);
+  static void call(T* lhs, T* rhs) noexcept(is_noexcept) {
+    move_assigner<T>::call(lhs, rhs);
+    rhs->~T();
+  }
+};
 
 /// wrapper class for any deleted move/copy operations, to be inherited at
 /// the same level as basic_static_ptr. this allows static_ptr to conditionally
@@ -165,312 +316,850 @@ class deleted_ops : move_constructer<T>, move_assigner<T>,
                     copy_constructer<T>, copy_assigner<T> {};
 
 /// helper template that checks whether a Derived class provides all of the
-/// move and copy operations exposed by its Base class. this is required
-/// because static_ptr enables these operations based on the Base class
+/// move and copy operations exposed by its Base class, and takes the trivial
+/// fast paths that Base selects. this is required because static_ptr enables
+/// these operations based on the Base class
 template <typename Base, typename Derived>
-class supports_same_ops {
-  // evaluates to false if Base supports the operation and Derived does not
-  template <template<typename> typename Op>
-  struct pred_t {
-    static constexpr bool value{!Op<Base>::value || Op<Derived>::value};
-  };
-
-  static constexpr bool v1 = pred_t<std::is_default_constructible>::value;
-  static constexpr bool n1 = pred_t<std::is_nothrow_default_constructible>::value;
-  static constexpr bool v2 = pred_t<std::is_move_constructible>::value;
-  static constexpr bool n2 = pred_t<std::is_nothrow_move_constructible>::value;
-  static constexpr bool v3 = pred_t<std::is_move_assignable>::value;
-  static constexpr bool n3 = pred_t<std::is_nothrow_move_assignable>::value;
-  static constexpr bool v4 = pred_t<std::is_copy_constructible>::value;
-  static constexpr bool n4 = pred_t<std::is_nothrow_copy_constructible>::value;
-  static constexpr bool v5 = pred_t<std::is_copy_assignable>::value;
-  static constexpr bool n5 = pred_t<std::is_nothrow_copy_assignable>::value;
-  static constexpr bool v6 = pred_t<std::is_destructible>::value;
-  static constexpr bool n6 = pred_t<std::is_nothrow_destructible>::value;
+struct supports_same_ops : std::integral_constant<bool,
+    (capabilities<Base>::value & ~capabilities<Derived>::value) == 0> {};
 
- public:
-  static constexpr bool value{v1 && v2 && v3 && v4 && v5 && v6 &&
-                              n1 && n2 && n3 && n4 && n5 && n6};
+constexpr size_t max2(size_t a, size_t b) { return a < b ? b : a; }
+constexpr size_t min2(size_t a, size_t b) { return a < b ? a : b; }
+
+constexpr size_t max_of() { return 0; }
+template <typename ...Rest>
+constexpr size_t max_of(size_t first, Rest... rest) {
+  return max2(first, max_of(rest...));
+}
+constexpr size_t min_of(size_t first) { return first; }
+template <typename ...Rest>
+constexpr size_t min_of(size_t first, size_t second, Rest... rest) {
+  return min2(first, min_of(second, rest...));
+}
+
+constexpr bool all_of() { return true; }
+template <typename ...Rest>
+constexpr bool all_of(bool first, Rest... rest) {
+  return first && all_of(rest...);
+}
+
+/// 1-based index of U in Us, or 0 if not found
+template <typename U, typename ...Us>
+struct index_of;
+template <typename U>
+struct index_of<U> : std::integral_constant<size_t, 0> {};
+template <typename U, typename ...Us>
+struct index_of<U, U, Us...> : std::integral_constant<size_t, 1> {};
+template <typename U, typename V, typename ...Us>
+struct index_of<U, V, Us...> : std::integral_constant<size_t,
+    index_of<U, Us...>::value ? index_of<U, Us...>::value + 1 : 0> {};
+
+/// determine whether static_ptr<U, S2, A2> is convertible to
+/// static_ptr<T, S, A>. anything stored in the source must be sufficiently
+/// aligned in the target, and a bitwise move or copy from U is only valid if
+/// U takes the fast path too
+template <typename T, size_t S, size_t A, typename U, size_t S2, size_t A2>
+struct is_convertible : std::integral_constant<bool,
+    S2 <= S && A2 <= A && std::is_base_of<U, T>::value &&
+    supports_same_ops<U, T>::value &&
+    ((capabilities<U>::value ^ capabilities<T>::value) &
+     (cap_trivially_relocatable | cap_trivially_copyable)) == 0> {};
+
+/// table of type-erased operations for a stored type. entries are null when
+/// the operation is trivial for that type, so callers can skip the call: a
+/// null relocate or copy is done with memcpy, and a null destruct is a no-op
+struct op_table {
+  /// identity of the stored type, pointing at its canonical table
+  const op_table* id;
+  /// size and alignment of the stored type
+  std::size_t size;
+  std::size_t align;
+  void (*relocate)(void* dst, void* src);
+  void (*relocate_assign)(void* dst, void* src);
+  void (*copy_construct)(void* dst, const void* src);
+  void (*copy_assign)(void* dst, const void* src);
+  void (*destruct)(void* dst);
+#ifdef STATIC_PTR_ENABLE_OP_STATS
+  /// operation counters of the stored type
+  type_stats* stats;
+#endif
 };
+
+/// op_table extended with typed loops over n objects spaced stride bytes
+/// apart, so arrays of buffers pay one indirect call per run of objects of
+/// the same type. only canonical tables have these, so they're reached
+/// through op_table::id. entries are null where the operation is trivial
+struct bulk_op_table : op_table {
+  void (*relocate_n)(void* dst, void* src, std::size_t n, std::size_t stride);
+  void (*copy_construct_n)(void* dst, const void* src, std::size_t n,
+                           std::size_t stride);
+  void (*destruct_n)(void* dst, std::size_t n, std::size_t stride);
+
+  constexpr bulk_op_table(
+      const op_table& ops,
+      void (*relocate_n)(void*, void*, std::size_t, std::size_t),
+      void (*copy_construct_n)(void*, const void*, std::size_t, std::size_t),
+      void (*destruct_n)(void*, std::size_t, std::size_t))
+    : op_table(ops), relocate_n(relocate_n),
+      copy_construct_n(copy_construct_n), destruct_n(destruct_n) {}
+};
+
+/// the bulk operations of the type identified by id
+inline const bulk_op_table* bulk_ops(const op_table* id) noexcept {
+  return static_cast<const bulk_op_table*>(id);
+}
+
+/// table entries for the move and copy operations that a type lacks, shared
+/// by all types. static_ptr and its relatives reject these operations at
+/// compile time, so they're only reached through a type-erased table
+struct disabled_ops {
+  [[noreturn]] static void fail(const char* what) {
+    throw_or_abort(std::logic_error(what));
+  }
+  static void relocate(void*, void*) {
+    fail("move constructor disabled");
+  }
+  static void relocate_assign(void*, void*) {
+    fail("move assignment disabled");
+  }
+  static void copy_construct(void*, const void*) {
+    fail("copy constructor disabled");
+  }
+  static void copy_assign(void*, const void*) {
+    fail("copy assignment disabled");
+  }
+  static void relocate_n(void*, void*, std::size_t, std::size_t) {
+    fail("move constructor disabled");
+  }
+  static void copy_construct_n(void*, const void*, std::size_t, std::size_t) {
+    fail("copy constructor disabled");
+  }
+};
+
+/// the canonical op_table for type T
 template <typename T>
-class supports_same_ops<T, T> {
- public:
-  static constexpr bool value{true};
+struct op_table_for {
+  static void relocate(void* dst, void* src) {
+    relocater<T>::call(static_cast<T*>(dst), static_cast<T*>(src));
+  }
+  static void relocate_assign(void* dst, void* src) {
+    relocate_assigner<T>::call(static_cast<T*>(dst), static_cast<T*>(src));
+  }
+  static void copy_construct(void* dst, const void* src) {
+    copy_constructer<T>::call(static_cast<T*>(dst), static_cast<const T*>(src));
+  }
+  static void copy_assign(void* dst, const void* src) {
+    copy_assigner<T>::call(static_cast<T*>(dst), static_cast<const T*>(src));
+  }
+  static void destruct(void* dst) {
+    static_cast<T*>(dst)->~T();
+  }
+
+  static T* at(void* p, size_t i, size_t stride) {
+    return reinterpret_cast<T*>(static_cast<unsigned char*>(p) + i * stride);
+  }
+  static const T* at(const void* p, size_t i, size_t stride) {
+    return reinterpret_cast<const T*>(
+        static_cast<const unsigned char*>(p) + i * stride);
+  }
+  static void relocate_n(void* dst, void* src, size_t n, size_t stride) {
+    for (size_t i = 0; i < n; i++) {
+      relocater<T>::call(at(dst, i, stride), at(src, i, stride));
+    }
+  }
+  /// destroys the objects it constructed if a copy throws
+  static void copy_construct_n(void* dst, const void* src, size_t n,
+                               size_t stride) {
+    struct guard {
+      void* dst;
+      size_t stride;
+      size_t done;
+      ~guard() { destruct_n(dst, done, stride); }
+    } g{dst, stride, 0};
+    for (; g.done < n; g.done++) {
+      copy_constructer<T>::call(at(dst, g.done, stride),
+                                at(src, g.done, stride));
+    }
+    g.done = 0;
+  }
+  static void destruct_n(void* dst, size_t n, size_t stride) {
+    for (size_t i = 0; i < n; i++) {
+      at(dst, i, stride)->~T();
+    }
+  }
+
+  static constexpr bool trivial_relocate = has_caps<T>(cap_trivially_relocatable);
+  static constexpr bool trivial_copy = has_caps<T>(cap_trivially_copyable);
+  static constexpr bool trivial_destruct = has_caps<T>(cap_trivially_destructible);
+  // table entries for operations that T has, or the shared entries of
+  // disabled_ops for those it lacks, selected by overload so that the typed
+  // operations are only instantiated where they're enabled
+  using relocate_fn = void (*)(void* dst, void* src);
+  using copy_fn = void (*)(void* dst, const void* src);
+  using relocate_n_fn = void (*)(void* dst, void* src, size_t n, size_t stride);
+  using copy_n_fn = void (*)(void* dst, const void* src, size_t n,
+                             size_t stride);
+  template <bool B>
+  using enabled = std::integral_constant<bool, B>;
+  using can_relocate = enabled<relocater<T>::enabled>;
+  using can_relocate_assign = enabled<relocate_assigner<T>::enabled>;
+  using can_copy = enabled<copy_constructer<T>::enabled>;
+  using can_copy_assign = enabled<copy_assigner<T>::enabled>;
+
+  static constexpr relocate_fn relocate_op(std::true_type) { return &relocate; }
+  static constexpr relocate_fn relocate_op(std::false_type) {
+    return &disabled_ops::relocate;
+  }
+  static constexpr relocate_fn relocate_assign_op(std::true_type) {
+    return &relocate_assign;
+  }
+  static constexpr relocate_fn relocate_assign_op(std::false_type) {
+    return &disabled_ops::relocate_assign;
+  }
+  static constexpr copy_fn copy_construct_op(std::true_type) {
+    return &copy_construct;
+  }
+  static constexpr copy_fn copy_construct_op(std::false_type) {
+    return &disabled_ops::copy_construct;
+  }
+  static constexpr copy_fn copy_assign_op(std::true_type) {
+    return &copy_assign;
+  }
+  static constexpr copy_fn copy_assign_op(std::false_type) {
+    return &disabled_ops::copy_assign;
+  }
+  static constexpr relocate_n_fn relocate_n_op(std::true_type) {
+    return &relocate_n;
+  }
+  static constexpr relocate_n_fn relocate_n_op(std::false_type) {
+    return &disabled_ops::relocate_n;
+  }
+  static constexpr copy_n_fn copy_construct_n_op(std::true_type) {
+    return &copy_construct_n;
+  }
+  static constexpr copy_n_fn copy_construct_n_op(std::false_type) {
+    return &disabled_ops::copy_construct_n;
+  }
+
+  static const bulk_op_table table;
+};
+// defined out of class so the table can refer to its own address. the
+// initializer is a constant expression, so this is constant-initialized
+template <typename T>
+const bulk_op_table op_table_for<T>::table{op_table{
+  &op_table_for<T>::table,
+  sizeof(T),
+  alignof(T),
+  op_table_for<T>::trivial_relocate ? nullptr :
+      op_table_for<T>::relocate_op(typename op_table_for<T>::can_relocate{}),
+  op_table_for<T>::trivial_relocate ? nullptr :
+      op_table_for<T>::relocate_assign_op(
+          typename op_table_for<T>::can_relocate_assign{}),
+  op_table_for<T>::trivial_copy ? nullptr :
+      op_table_for<T>::copy_construct_op(typename op_table_for<T>::can_copy{}),
+  op_table_for<T>::trivial_copy ? nullptr :
+      op_table_for<T>::copy_assign_op(
+          typename op_table_for<T>::can_copy_assign{}),
+  op_table_for<T>::trivial_destruct ? nullptr : &op_table_for<T>::destruct,
+#ifdef STATIC_PTR_ENABLE_OP_STATS
+  &type_stats_for<T>::stats,
+#endif
+  },
+  op_table_for<T>::trivial_relocate ? nullptr :
+      op_table_for<T>::relocate_n_op(typename op_table_for<T>::can_relocate{}),
+  op_table_for<T>::trivial_copy ? nullptr :
+      op_table_for<T>::copy_construct_n_op(
+          typename op_table_for<T>::can_copy{}),
+  op_table_for<T>::trivial_destruct ? nullptr : &op_table_for<T>::destruct_n,
 };
 
-/// determine whether static_ptr<U, S2> is convertible to static_ptr<T, S>
-template <typename T, size_t S, typename U, size_t S2>
-class is_convertible {
-  static constexpr bool v1 = S2 <= S;
-  static constexpr bool v2 = std::is_base_of<U, T>::value;
-  static constexpr bool v3 = _::supports_same_ops<U, T>::value;
+/// op table policy that stores a pointer to the canonical table
+class pointer_ops {
+  const op_table* table{nullptr};
  public:
-  static constexpr bool value{v1 && v2 && v3};
+  pointer_ops() = default;
+  STATIC_PTR_CONSTEXPR20 pointer_ops(const op_table* table) noexcept
+    : table(table) {}
+
+  const op_table* get() const noexcept { return table; }
+  const op_table* operator->() const noexcept { return table; }
+  explicit operator bool() const noexcept { return table != nullptr; }
 };
 
-/// type erasure implementation that operates through a pointer to a
-/// function templated on the actual type T
-class type_erasure_ops {
- protected:
-  enum class operation {
-    move_construct,
-    move_assign,
-    copy_construct,
-    copy_assign,
-    destruct,
-  };
+/// op table policy that embeds a copy of the table in the handle, trading
+/// size for one less indirection on every operation
+class inline_ops {
+  op_table table{};
+ public:
+  inline_ops() = default;
+  inline_ops(const op_table* table) noexcept
+    : table(table ? *table : op_table{}) {}
 
-  template <typename T>
-  static void void_operate(operation op, void* dst, void* src) {
-    auto lhs = static_cast<T*>(dst);
-    auto rhs = static_cast<T*>(src);
-    switch (op) {
-      case operation::move_construct:
-        move_constructer<T>::call(lhs, rhs);
-        break;
-      case operation::move_assign:
-        move_assigner<T>::call(lhs, rhs);
-        break;
-      case operation::copy_construct:
-        copy_constructer<T>::call(lhs, rhs);
-        break;
-      case operation::copy_assign:
-        copy_assigner<T>::call(lhs, rhs);
-        break;
-      case operation::destruct:
-        lhs->~T();
-        break;
+  const op_table* get() const noexcept { return table.id; }
+  const op_table* operator->() const noexcept { return &table; }
+  explicit operator bool() const noexcept { return table.id != nullptr; }
+};
+
+#ifdef STATIC_PTR_ENABLE_LAYOUT_STATS
+/// op table policy wrapper that counts the handles that hold it, and the
+/// objects it points to, in the layout_stats of Stats
+template <typename Ops, typename Stats>
+class layout_tracked_ops : public Ops {
+  static void add(const op_table* table) noexcept {
+    if (table) {
+      Stats::stats.add_object(table->size);
     }
   }
+  static void remove(const op_table* table) noexcept {
+    if (table) {
+      Stats::stats.remove_object(table->size);
+    }
+  }
+ public:
+  layout_tracked_ops() noexcept { Stats::stats.add_handle(); }
+  layout_tracked_ops(const op_table* table) noexcept : Ops(table) {
+    Stats::stats.add_handle();
+    add(table);
+  }
+  layout_tracked_ops(const layout_tracked_ops& o) noexcept : Ops(o) {
+    Stats::stats.add_handle();
+    add(o.get());
+  }
+  ~layout_tracked_ops() {
+    remove(this->get());
+    Stats::stats.remove_handle();
+  }
+  layout_tracked_ops& operator=(const op_table* table) noexcept {
+    remove(this->get());
+    Ops::operator=(Ops(table));
+    add(table);
+    return *this;
+  }
+  layout_tracked_ops& operator=(const layout_tracked_ops& o) noexcept {
+    return *this = o.get();
+  }
+};
 
+template <typename T, size_t S, size_t A> class basic_static_ptr;
+
+/// the layout_stats of basic_static_ptr<T, S, A>
+template <typename T, size_t S, size_t A>
+struct layout_stats_for {
+  static layout_stats stats;
+};
+template <typename T, size_t S, size_t A>
+layout_stats layout_stats_for<T, S, A>::stats{
+    &typeid(T), S, A, sizeof(basic_static_ptr<T, S, A>)};
+#endif
+
+} // namespace _
+
+/// policy trait that selects how a static_ptr<T> stores its op table.
+/// defaults to a pointer to the table; specialize as std::true_type to embed
+/// the table in each handle for the hottest types
+template <typename T>
+struct use_inline_op_table : std::false_type {};
+
+namespace _ {
+
+/// type erasure implementation that operates through a per-type table of
+/// functions templated on the actual type T
+class type_erasure_ops {
  public:
-  using op_fn = void(*)(operation op, void* dst, void* src);
+  /// identifies the stored type and its operations
+  using op_fn = const op_table*;
 
   template <typename T, typename DecayT = typename std::decay<T>::type>
-  static constexpr op_fn get_operate() { return void_operate<DecayT>; }
+  static constexpr op_fn get_operate() { return &op_table_for<DecayT>::table; }
 
-  void move_construct(void* buffer, op_fn& operate,
-                      void* other, op_fn& other_op) {
+  /// storage for the op table of a static_ptr<T>, per use_inline_op_table<T>
+  template <typename T>
+  using op_storage = typename std::conditional<
+      use_inline_op_table<T>::value, inline_ops, pointer_ops>::type;
+
+  /// move-construct from other with static size Size into an empty buffer
+  template <size_t Size, typename Ops, typename OtherOps>
+  void move_construct(void* buffer, Ops& operate,
+                      void* other, OtherOps& other_op) {
     if (other_op) {
-      other_op(operation::move_construct, buffer, other);
-      other_op(operation::destruct, other, nullptr);
-      std::swap(operate, other_op);
+      STATIC_PTR_RECORD_OPS(other_op, move);
+      if (auto relocate = other_op->relocate) {
+        relocate(buffer, other);
+      } else {
+        std::memcpy(buffer, other, Size);
+      }
+      operate = other_op.get();
+      other_op = nullptr;
     }
   }
 
-  void move_assign(void* buffer, op_fn& operate,
-                   void* other, op_fn& other_op) {
+  template <size_t Size, typename Ops, typename OtherOps>
+  void move_assign(void* buffer, Ops& operate,
+                   void* other, OtherOps& other_op) {
     if (operate) {
-      if (operate == other_op) {
+      if (operate.get() == other_op.get()) {
         // already constructed and same type T as other
-        other_op(operation::move_assign, buffer, other);
-        other_op(operation::destruct, other, nullptr);
+        STATIC_PTR_RECORD_OPS(other_op, move);
+        if (auto relocate_assign = other_op->relocate_assign) {
+          relocate_assign(buffer, other);
+        } else {
+          destruct(buffer, operate);
+          std::memcpy(buffer, other, Size);
+        }
         other_op = nullptr;
         return;
       }
-      operate(operation::destruct, buffer, nullptr);
+      if (other_op) {
+        STATIC_PTR_RECORD_OPS(other_op, cross_type_assign);
+      }
+      destruct(buffer, operate);
       operate = nullptr;
     }
-    move_construct(buffer, operate, other, other_op);
+    move_construct<Size>(buffer, operate, other, other_op);
   }
 
-  void copy_construct(void* buffer, op_fn& operate,
-                      const void* other, op_fn other_op) {
+  template <size_t Size, typename Ops, typename OtherOps>
+  void copy_construct(void* buffer, Ops& operate,
+                      const void* other, const OtherOps& other_op) {
     if (other_op) {
-      other_op(operation::copy_construct, buffer, const_cast<void*>(other));
-      operate = other_op;
+      STATIC_PTR_RECORD_OPS(other_op, copy);
+      if (auto copy_construct = other_op->copy_construct) {
+        copy_construct(buffer, other);
+      } else {
+        std::memcpy(buffer, other, Size);
+      }
+      operate = other_op.get();
     }
   }
 
-  void copy_assign(void* buffer, op_fn& operate,
-                   const void* other, op_fn other_op) {
+  template <size_t Size, typename Ops, typename OtherOps>
+  void copy_assign(void* buffer, Ops& operate,
+                   const void* other, const OtherOps& other_op) {
     if (operate) {
-      if (operate == other_op) {
+      if (operate.get() == other_op.get()) {
         // already constructed and same type T as other
-        other_op(operation::copy_assign, buffer, const_cast<void*>(other));
+        STATIC_PTR_RECORD_OPS(other_op, copy);
+        if (auto copy_assign = other_op->copy_assign) {
+          copy_assign(buffer, other);
+        } else {
+          std::memcpy(buffer, other, Size);
+        }
         return;
       }
-      operate(operation::destruct, buffer, nullptr);
+      if (other_op) {
+        STATIC_PTR_RECORD_OPS(other_op, cross_type_assign);
+      }
+      destruct(buffer, operate);
       operate = nullptr;
     }
-    copy_construct(buffer, operate, other, other_op);
+    copy_construct<Size>(buffer, operate, other, other_op);
   }
 
-  void destruct(void* buffer, op_fn& operate) {
-    operate(operation::destruct, buffer, nullptr);
+  template <typename Ops>
+  void destruct(void* buffer, const Ops& operate) {
+    if (auto destruct = operate->destruct) {
+      destruct(buffer);
+    }
   }
 };
 
-template <typename T, size_t S>
+template <typename T, size_t S, size_t A = alignof(T)>
 class basic_static_ptr : protected type_erasure_ops {
+  static_assert(A >= alignof(T), "A is too small for T");
+
+ public:
+  /// trivial fast paths that bypass the type-erased operations.
+  /// supports_same_ops guarantees that these also hold for any type derived
+  /// from T that is stored in the buffer
+  static constexpr bool trivial_relocate = has_caps<T>(cap_trivially_relocatable);
+  static constexpr bool trivial_copy = has_caps<T>(cap_trivially_copyable);
+  static constexpr bool trivial_destruct = has_caps<T>(cap_trivially_destructible);
+  /// whether swapping relocates in place without throwing, rather than
+  /// moving through a temporary
+  static constexpr bool nothrow_swap = trivial_relocate ||
+      relocater<T>::is_noexcept;
+
+  /// storage type for a single object in arrays of buffers
+  using buffer_type = typename std::aligned_storage<S, A>::type;
+
  protected:
-  /// static storage for placement new
-  typename std::aligned_storage<S, alignof(T)>::type buffer;
+  /// static storage for placement new. unlike buffer_type, this isn't padded
+  /// to a multiple of A, so the op table can share the last aligned block
+  alignas(A) unsigned char buffer[S];
+
+  /// op table for the stored type, null while no object is constructed
+#ifdef STATIC_PTR_ENABLE_LAYOUT_STATS
+  layout_tracked_ops<op_storage<T>, layout_stats_for<T, S, A>> operate;
+#else
+  op_storage<T> operate;
+#endif
+
+  /// destruct the current object, if any
+  STATIC_PTR_CONSTEXPR20 void destroy() {
+    if (operate) {
+      if (!trivial_destruct) {
+        destruct(&buffer, operate);
+      }
+      operate = nullptr;
+    }
+  }
+
+  /// count an assignment from other_op over an object of another type
+  template <typename OtherOps>
+  void record_cross_type(const OtherOps& other_op) const noexcept {
+#ifdef STATIC_PTR_ENABLE_OP_STATS
+    if (operate && other_op && operate.get() != other_op.get()) {
+      STATIC_PTR_RECORD_OPS(other_op, cross_type_assign);
+    }
+#else
+    (void)other_op;
+#endif
+  }
 
-  /// function pointer for operations, null while no object is constructed
-  op_fn operate{nullptr};
+  /// move from the buffer of a basic_static_ptr with static size S2 <= S
+  template <size_t S2, typename OtherOps>
+  void move_from(void* other, OtherOps& other_op) {
+    if (trivial_relocate) {
+      if (other_op) {
+        STATIC_PTR_RECORD_OPS(other_op, move);
+        std::memcpy(&buffer, other, S2);
+        operate = other_op.get();
+        other_op = nullptr;
+      }
+    } else {
+      move_construct<S2>(&buffer, operate, other, other_op);
+    }
+  }
+  template <size_t S2, typename OtherOps>
+  void move_assign_from(void* other, OtherOps& other_op) {
+    if (trivial_relocate) {
+      record_cross_type(other_op);
+      destroy();
+      move_from<S2>(other, other_op);
+    } else {
+      move_assign<S2>(&buffer, operate, other, other_op);
+    }
+  }
+
+  /// copy from the buffer of a basic_static_ptr with static size S2 <= S
+  template <size_t S2, typename OtherOps>
+  void copy_from(const void* other, const OtherOps& other_op) {
+    if (trivial_copy) {
+      if (other_op) {
+        STATIC_PTR_RECORD_OPS(other_op, copy);
+        std::memcpy(&buffer, other, S2);
+        operate = other_op.get();
+      }
+    } else {
+      copy_construct<S2>(&buffer, operate, other, other_op);
+    }
+  }
+  template <size_t S2, typename OtherOps>
+  void copy_assign_from(const void* other, const OtherOps& other_op) {
+    if (other == &buffer) {
+      // self-assignment, where other_op is operate and destroy() clears it
+      return;
+    }
+    if (trivial_copy) {
+      record_cross_type(other_op);
+      destroy();
+      copy_from<S2>(other, other_op);
+    } else {
+      copy_assign<S2>(&buffer, operate, other, other_op);
+    }
+  }
+
+  /// relocate an object of the type of ops from src to dst
+  template <typename Ops>
+  static void relocate_object(void* dst, void* src, const Ops& ops) {
+    STATIC_PTR_RECORD_OPS(ops, move);
+    if (auto relocate = ops->relocate) {
+      relocate(dst, src);
+    } else {
+      std::memcpy(dst, src, ops->size);
+    }
+  }
+
+  /// exchange objects with o by relocation: a byte swap of the buffers when
+  /// T is trivially relocatable, otherwise one relocation if either side is
+  /// empty, or three through a temporary buffer
+  void swap_with(basic_static_ptr& o) noexcept {
+    static_assert(nothrow_swap, "swap_with requires nothrow relocation");
+    if (this == &o) {
+      // the relocations below would overlap, e.g. for std::iter_swap(i, i)
+      return;
+    }
+    const op_fn ops = operate.get();
+    const op_fn other_ops = o.operate.get();
+    if (trivial_relocate) {
+      alignas(A) unsigned char tmp[S];
+      std::memcpy(tmp, &buffer, S);
+      std::memcpy(&buffer, &o.buffer, S);
+      std::memcpy(&o.buffer, tmp, S);
+    } else if (!ops) {
+      if (!other_ops) {
+        return;
+      }
+      relocate_object(&buffer, &o.buffer, other_ops);
+    } else if (!other_ops) {
+      relocate_object(&o.buffer, &buffer, ops);
+    } else {
+      alignas(A) unsigned char tmp[S];
+      relocate_object(tmp, &buffer, ops);
+      relocate_object(&buffer, &o.buffer, other_ops);
+      relocate_object(&o.buffer, tmp, ops);
+    }
+    operate = other_ops;
+    o.operate = ops;
+  }
+
+#ifdef STATIC_PTR_HAS_CONSTEXPR
+  /// constant evaluation can't placement new into the byte buffer, so store
+  /// the object representation of a trivially copyable U instead
+  template <typename U, typename ...Args>
+  constexpr void constant_construct(Args&&... args) {
+    if constexpr (std::is_trivially_copyable<U>::value) {
+      const auto bytes = std::bit_cast<std::array<unsigned char, sizeof(U)>>(
+          U(std::forward<Args>(args)...));
+      for (size_t i = 0; i < S; i++) {
+        buffer[i] = i < sizeof(U) ? bytes[i] : 0;
+      }
+    } else {
+      new (&buffer) U(std::forward<Args>(args)...);
+    }
+  }
+#endif
 
  public:
+#ifdef STATIC_PTR_HAS_CONSTEXPR
+  /// the buffer is left uninitialized, except in constant evaluation where
+  /// the value of a constinit static_ptr must be fully initialized
+  constexpr basic_static_ptr() noexcept {
+    if (std::is_constant_evaluated()) {
+      for (auto& b : buffer) {
+        b = 0;
+      }
+    }
+  }
+#else
   basic_static_ptr() = default;
+#endif
   ~basic_static_ptr() = default;
-  explicit basic_static_ptr(op_fn operate) : operate(operate) {}
+  STATIC_PTR_CONSTEXPR20 explicit basic_static_ptr(op_fn operate)
+    : operate(operate) {}
 
   // move operations
   basic_static_ptr(basic_static_ptr&& o)
-      noexcept(move_constructer<T>::is_noexcept) {
+      noexcept(trivial_relocate || relocater<T>::is_noexcept) {
     static_assert(move_constructer<T>::enabled,
                   "must be MoveConstructible");
-    move_construct(&buffer, operate, &o.buffer, o.operate);
+    move_from<S>(&o.buffer, o.operate);
   }
   basic_static_ptr& operator=(basic_static_ptr&& o)
-      noexcept(move_assigner<T>::is_noexcept) {
+      noexcept(trivial_relocate ? has_caps<T>(cap_nothrow_destruct) :
+               (relocater<T>::is_noexcept &&
+                relocate_assigner<T>::is_noexcept)) {
     static_assert(move_assigner<T>::enabled,
                   "must be MoveAssignable");
-    move_assign(&buffer, operate, &o.buffer, o.operate);
+    move_assign_from<S>(&o.buffer, o.operate);
     return *this;
   }
 
   // copy operations
   basic_static_ptr(const basic_static_ptr& o)
-      noexcept(copy_constructer<T>::is_noexcept) {
+      noexcept(trivial_copy || copy_constructer<T>::is_noexcept) {
     static_assert(copy_constructer<T>::enabled,
                   "must be CopyConstructible");
-    copy_construct(&buffer, operate, &o.buffer, o.operate);
+    copy_from<S>(&o.buffer, o.operate);
   }
   basic_static_ptr& operator=(const basic_static_ptr& o)
-      noexcept(copy_assigner<T>::is_noexcept) {
+      noexcept(trivial_copy || copy_assigner<T>::is_noexcept) {
     static_assert(copy_assigner<T>::enabled,
                   "must be CopyAssignable");
-    copy_assign(&buffer, operate, &o.buffer, o.operate);
+    copy_assign_from<S>(&o.buffer, o.operate);
     return *this;
   }
 };
+template <typename T, size_t S, size_t A>
+constexpr bool basic_static_ptr<T, S, A>::trivial_relocate;
+template <typename T, size_t S, size_t A>
+constexpr bool basic_static_ptr<T, S, A>::trivial_copy;
+template <typename T, size_t S, size_t A>
+constexpr bool basic_static_ptr<T, S, A>::trivial_destruct;
+template <typename T, size_t S, size_t A>
+constexpr bool basic_static_ptr<T, S, A>::nothrow_swap;
 
 } // namespace _
 
-template <typename T, size_t S = sizeof(T)>
-class static_ptr : public _::basic_static_ptr<T, S>, _::deleted_ops<T> {
+template <typename T, size_t S, size_t A> class seqlock_static_ptr;
+template <typename T, size_t S, size_t A> class stable_static_ptr;
+namespace _ { struct static_ptr_range; }
+
+/// A is the alignment of the buffer, which may be raised above alignof(T) to
+/// hold over-aligned derived types, or to pad the static_ptr to a cache line.
+/// note that dynamic allocation only honors such extended alignment in c++17
+template <typename T, size_t S = sizeof(T), size_t A = alignof(T)>
+class static_ptr : public _::basic_static_ptr<T, S, A>, _::deleted_ops<T> {
   static_assert(sizeof(T) <= S, "S is too small for T");
 
-  using Base = _::basic_static_ptr<T, S>;
+  using Base = _::basic_static_ptr<T, S, A>;
   using Base::buffer;
-  using Base::destruct;
+  using Base::destroy;
   using Base::operate;
 
   /// support conversions of type and size
-  template <typename U, size_t S2> friend class static_ptr;
+  template <typename U, size_t S2, size_t A2> friend class static_ptr;
+  /// publishes into and snapshots out of the buffer
+  template <typename U, size_t S2, size_t A2> friend class seqlock_static_ptr;
+  /// loads from the buffer of a stable_static_ptr
+  template <typename U, size_t S2, size_t A2> friend class stable_static_ptr;
+  /// batches operations over arrays of handles
+  friend struct _::static_ptr_range;
 
  public:
   static_ptr() = default;
-  ~static_ptr() {
-    if (operate) {
-      destruct(&buffer, operate);
-    }
+  /// constexpr in c++20 so static_ptr is a literal type, though only trivially
+  /// destructible objects can be destroyed in constant expressions
+  STATIC_PTR_CONSTEXPR20 ~static_ptr() {
+    destroy();
   }
 
-  /// initializing constructor
+  /// initializing constructor. in c++20 this is usable in constant
+  /// expressions when U is a trivially copyable literal type
   template <typename U, typename ...Args>
-  static_ptr(in_place_t<U>, Args... args) noexcept(std::is_nothrow_constructible<U, Args...>::value)
+  STATIC_PTR_CONSTEXPR20 static_ptr(in_place_t<U>, Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value)
     : Base(_::type_erasure_ops::get_operate<U>()) {
     static_assert(sizeof(U) <= S,
                   "size of type is larger than static size");
+    static_assert(alignof(U) <= A,
+                  "alignment of type is larger than static alignment");
     static_assert(std::is_base_of<T, U>::value,
                   "initializing with incompatible type");
     static_assert(_::supports_same_ops<T, U>::value,
                   "move into basic_static_ptr with incompatible type");
+#ifdef STATIC_PTR_HAS_CONSTEXPR
+    if (std::is_constant_evaluated()) {
+      this->template constant_construct<U>(std::forward<Args>(args)...);
+      return;
+    }
+#endif
+    STATIC_PTR_RECORD(U, construct);
     new (&buffer) U(std::forward<Args>(args)...);
   }
 
   /// in-place (re)initialization
   template <typename U = T, typename ...Args>
-  void emplace(Args... args) noexcept(std::is_nothrow_constructible<U, Args...>::value) {
+  void emplace(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value &&
+               std::is_nothrow_destructible<T>::value) {
     static_assert(sizeof(U) <= S,
                   "size of type is larger than static size");
+    static_assert(alignof(U) <= A,
+                  "alignment of type is larger than static alignment");
     static_assert(std::is_base_of<T, U>::value,
                   "initializing with incompatible type");
     static_assert(_::supports_same_ops<T, U>::value,
                   "move into basic_static_ptr with incompatible type");
     reset();
+    STATIC_PTR_RECORD(U, construct);
     new (&buffer) U(std::forward<Args>(args)...);
-    operate = typename Base::template get_operate<U>();
+    operate = Base::template get_operate<U>();
   }
 
   // converting move operations
-  template <typename U, size_t S2,
+  template <typename U, size_t S2, size_t A2,
             typename = typename std::enable_if<
-                _::is_convertible<T, S, U, S2>::value>::type>
-  static_ptr(static_ptr<U, S2>&& o)
+                _::is_convertible<T, S, A, U, S2, A2>::value>::type>
+  static_ptr(static_ptr<U, S2, A2>&& o)
       noexcept(_::move_constructer<U>::is_noexcept &&
                std::is_nothrow_destructible<T>::value) {
     static_assert(S2 <= S,
                   "move into static_ptr with less static size");
+    static_assert(A2 <= A,
+                  "move into static_ptr with less alignment");
     static_assert(std::is_base_of<T, U>::value,
                   "move into static_ptr with incompatible type");
     static_assert(_::supports_same_ops<T, U>::value,
                   "move into static_ptr with incompatible type");
     static_assert(_::move_constructer<T>::enabled,
                   "must be MoveConstructible");
-    this->move_construct(&buffer, operate, &o.buffer, o.operate);
+    this->template move_from<S2>(&o.buffer, o.operate);
   }
-  template <typename U, size_t S2,
+  template <typename U, size_t S2, size_t A2,
             typename = typename std::enable_if<
-                _::is_convertible<T, S, U, S2>::value>::type>
-  static_ptr& operator=(static_ptr<U, S2>&& o)
+                _::is_convertible<T, S, A, U, S2, A2>::value>::type>
+  static_ptr& operator=(static_ptr<U, S2, A2>&& o)
       noexcept(_::move_assigner<U>::is_noexcept &&
                std::is_nothrow_destructible<T>::value) {
     static_assert(S2 <= S,
                   "move into static_ptr with less static size");
+    static_assert(A2 <= A,
+                  "move into static_ptr with less alignment");
     static_assert(std::is_base_of<T, U>::value,
                   "move into static_ptr with incompatible type");
     static_assert(_::supports_same_ops<T, U>::value,
                   "move into static_ptr with incompatible type");
     static_assert(_::move_assigner<T>::enabled,
                   "must be MoveAssignable");
-    this->move_assign(&buffer, operate, &o.buffer, o.operate);
+    this->template move_assign_from<S2>(&o.buffer, o.operate);
     return *this;
   }
 
   // converting copy operations
-  template <typename U, size_t S2,
+  template <typename U, size_t S2, size_t A2,
             typename = typename std::enable_if<
-                _::is_convertible<T, S, U, S2>::value>::type>
-  static_ptr(const static_ptr<U, S2>& o)
+                _::is_convertible<T, S, A, U, S2, A2>::value>::type>
+  static_ptr(const static_ptr<U, S2, A2>& o)
       noexcept(_::copy_constructer<U>::is_noexcept &&
                std::is_nothrow_destructible<T>::value) {
     static_assert(S2 <= S,
                   "copy into static_ptr with less static size");
+    static_assert(A2 <= A,
+                  "copy into static_ptr with less alignment");
     static_assert(std::is_base_of<T, U>::value,
                   "copy into static_ptr with incompatible type");
     static_assert(_::supports_same_ops<T, U>::value,
                   "move into static_ptr with incompatible type");
     static_assert(_::copy_constructer<U>::enabled,
                   "must be CopyConstructible");
-    this->copy_construct(&buffer, operate, &o.buffer, o.operate);
+    this->template copy_from<S2>(&o.buffer, o.operate);
   }
-  template <typename U, size_t S2,
+  template <typename U, size_t S2, size_t A2,
             typename = typename std::enable_if<
-                _::is_convertible<T, S, U, S2>::value>::type>
-  static_ptr& operator=(const static_ptr<U, S2>& o)
+                _::is_convertible<T, S, A, U, S2, A2>::value>::type>
+  static_ptr& operator=(const static_ptr<U, S2, A2>& o)
       noexcept(_::copy_assigner<U>::is_noexcept &&
                std::is_nothrow_destructible<T>::value) {
     static_assert(S2 <= S,
                   "copy into static_ptr with less static size");
+    static_assert(A2 <= A,
+                  "copy into static_ptr with less alignment");
     static_assert(std::is_base_of<T, U>::value,
                   "copy into static_ptr with incompatible type");
     static_assert(_::supports_same_ops<T, U>::value,
                   "move into static_ptr with incompatible type");
     static_assert(_::copy_assigner<U>::enabled,
                   "must be CopyAssignable");
-    this->copy_assign(&buffer, operate, &o.buffer, o.operate);
+    this->template copy_assign_from<S2>(&o.buffer, o.operate);
     return *this;
   }
 
   /// destruct an existing instance
   void reset() noexcept(std::is_nothrow_destructible<T>::value) {
-    if (operate) {
-      destruct(&buffer, operate);
-      operate = nullptr;
-    }
+    destroy();
+  }
+
+  /// exchange objects with o, relocating them in place rather than through
+  /// three moves of a temporary static_ptr
+  void swap(static_ptr& o) noexcept(Base::nothrow_swap) {
+    static_assert(Base::trivial_relocate || _::relocater<T>::enabled,
+                  "must be MoveConstructible");
+    swap(o, std::integral_constant<bool, Base::nothrow_swap>{});
+  }
+  friend void swap(static_ptr& l, static_ptr& r)
+      noexcept(Base::nothrow_swap) {
+    l.swap(r);
   }
 
   /// base pointer accessors
@@ -487,23 +1176,155 @@ class static_ptr : public _::basic_static_ptr<T, S>, _::deleted_ops<T> {
   T* operator->() noexcept { return get(); }
   const T* operator->() const noexcept { return get(); }
 
-  operator bool() const noexcept { return operate != nullptr; }
+  operator bool() const noexcept { return static_cast<bool>(operate); }
 
   /// member factory function
   /// easier to use through typedef, i.e:
   /// using base_ptr = static_ptr<base, sizeof(derived)>;
   /// auto p = base_ptr::make<derived>();
   template <typename U = T, typename ...Args>
-  static static_ptr make(Args... args) {
+  STATIC_PTR_CONSTEXPR20 static static_ptr make(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value) {
     return {in_place_t<U>{}, std::forward<Args>(args)...};
   }
+
+ private:
+  void swap(static_ptr& o, std::true_type) noexcept {
+    this->swap_with(o);
+  }
+  /// a relocation may throw, so swap through moves of a temporary that
+  /// destroys any object left in it
+  void swap(static_ptr& o, std::false_type) {
+    static_ptr tmp{std::move(o)};
+    o = std::move(*this);
+    *this = std::move(tmp);
+  }
 };
 
 /// free factory function
-template <typename B, size_t S, typename T, typename ...Args>
-inline static_ptr<B, S> make_static_ptr(Args... args)
+template <typename B, size_t S, typename T, size_t A = alignof(B),
+          typename ...Args>
+inline STATIC_PTR_CONSTEXPR20 static_ptr<B, S, A> make_static_ptr(Args&&... args)
+    noexcept(std::is_nothrow_constructible<T, Args&&...>::value)
 {
   return {in_place_t<T>{}, std::forward<Args>(args)...};
 }
 
+/// a static_ptr whose size and alignment are the minimum that holds each of
+/// the candidate types Us, and which rejects construction from any other
+/// type. slack<U>() and slack_bytes report how many bytes of the buffer each
+/// candidate leaves unused, so oversized reservations can be caught with a
+/// static_assert, i.e:
+/// using shape_ptr = static_ptr_for<shape, square, circle>;
+/// static_assert(shape_ptr::max_slack <= 8, "shape_ptr wastes space");
+/// it converts to the equivalent static_ptr, or to any larger one
+template <typename T, typename ...Us>
+class static_ptr_for
+    : public static_ptr<T, _::max_of(sizeof(T), sizeof(Us)...),
+                        _::max_of(alignof(T), alignof(Us)...)> {
+  static_assert(sizeof...(Us) > 0, "static_ptr_for requires candidate types");
+
+ public:
+  static constexpr size_t size = _::max_of(sizeof(T), sizeof(Us)...);
+  static constexpr size_t alignment = _::max_of(alignof(T), alignof(Us)...);
+
+  using static_ptr_type = static_ptr<T, size, alignment>;
+
+  /// whether U is one of the candidate types
+  template <typename U>
+  static constexpr bool is_candidate() {
+    return _::index_of<typename std::decay<U>::type, Us...>::value != 0;
+  }
+
+  /// unused bytes of the buffer when holding a U
+  template <typename U>
+  static constexpr size_t slack() {
+    static_assert(is_candidate<U>(), "type is not a candidate");
+    return size - sizeof(U);
+  }
+  /// unused bytes for each of the candidate types, in order
+  static constexpr size_t slack_bytes[sizeof...(Us)] = {size - sizeof(Us)...};
+  /// unused bytes for the smallest candidate type
+  static constexpr size_t max_slack = size - _::min_of(sizeof(Us)...);
+
+  static_ptr_for() = default;
+
+  /// initializing constructor
+  template <typename U, typename ...Args>
+  static_ptr_for(in_place_t<U>, Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value)
+    : static_ptr_type(in_place_t<U>{}, std::forward<Args>(args)...) {
+    static_assert(is_candidate<U>(), "type is not a candidate");
+  }
+
+  /// in-place (re)initialization
+  template <typename U, typename ...Args>
+  void emplace(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value &&
+               std::is_nothrow_destructible<T>::value) {
+    static_assert(is_candidate<U>(), "type is not a candidate");
+    static_ptr_type::template emplace<U>(std::forward<Args>(args)...);
+  }
+
+  /// member factory function
+  template <typename U, typename ...Args>
+  static static_ptr_for make(Args&&... args)
+      noexcept(std::is_nothrow_constructible<U, Args&&...>::value) {
+    return {in_place_t<U>{}, std::forward<Args>(args)...};
+  }
+};
+
+template <typename T, typename ...Us>
+constexpr size_t static_ptr_for<T, Us...>::size;
+template <typename T, typename ...Us>
+constexpr size_t static_ptr_for<T, Us...>::alignment;
+template <typename T, typename ...Us>
+constexpr size_t static_ptr_for<T, Us...>::slack_bytes[sizeof...(Us)];
+template <typename T, typename ...Us>
+constexpr size_t static_ptr_for<T, Us...>::max_slack;
+
+/// memory footprint of a static_ptr<T, S, A> that holds a U, for finding
+/// oversized buffers at compile time, i.e:
+/// static_assert(static_ptr_layout<shape, 64, circle>::wasted <= 16, "");
+template <typename T, size_t S = sizeof(T), typename U = T,
+          size_t A = alignof(T)>
+struct static_ptr_layout {
+  static_assert(sizeof(U) <= S, "size of type is larger than static size");
+  static_assert(alignof(U) <= A,
+                "alignment of type is larger than static alignment");
+
+  using static_ptr_type = static_ptr<T, S, A>;
+
+  /// total size of the handle
+  static constexpr size_t size = sizeof(static_ptr_type);
+  /// size of the buffer
+  static constexpr size_t buffer_size = S;
+  /// size of the stored op table pointer, or inline op table
+  static constexpr size_t op_size =
+      sizeof(_::type_erasure_ops::op_storage<T>);
+  /// bytes added to round the handle up to its alignment
+  static constexpr size_t padding = size - S - op_size;
+  /// size of the stored object
+  static constexpr size_t object_size = sizeof(U);
+  /// unused bytes of the buffer
+  static constexpr size_t slack = S - sizeof(U);
+  /// bytes of the handle not taken by the object: slack, op table and padding
+  static constexpr size_t wasted = size - sizeof(U);
+};
+
+template <typename T, size_t S, typename U, size_t A>
+constexpr size_t static_ptr_layout<T, S, U, A>::size;
+template <typename T, size_t S, typename U, size_t A>
+constexpr size_t static_ptr_layout<T, S, U, A>::buffer_size;
+template <typename T, size_t S, typename U, size_t A>
+constexpr size_t static_ptr_layout<T, S, U, A>::op_size;
+template <typename T, size_t S, typename U, size_t A>
+constexpr size_t static_ptr_layout<T, S, U, A>::padding;
+template <typename T, size_t S, typename U, size_t A>
+constexpr size_t static_ptr_layout<T, S, U, A>::object_size;
+template <typename T, size_t S, typename U, size_t A>
+constexpr size_t static_ptr_layout<T, S, U, A>::slack;
+template <typename T, size_t S, typename U, size_t A>
+constexpr size_t static_ptr_layout<T, S, U, A>::wasted;
+
 } // namespace static_ptr
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+// uninitialized memory algorithms over contiguous arrays of static_ptr
+// handles, for containers that manage their own storage. consecutive handles
+// whose objects share a typed operation are processed as a run, with one
+// indirect call for the whole run, and runs of trivial operations are copied
+// with a single memcpy. the source and destination ranges must not overlap
+
+namespace static_ptr {
+
+namespace _ {
+
+/// implementation of the range algorithms, with access to the buffer and op
+/// table of each handle
+struct static_ptr_range {
+  template <typename T, size_t S, size_t A>
+  using ptr = static_ptr<T, S, A>;
+
+  /// runs are split into chunks of this many handles, so that a chunk is
+  /// still in cache after scanning it
+  static constexpr size_t max_run = 64;
+
+  /// end of the run of handles from i that share the bulk operation selected
+  /// by Fn, which is null for empty handles and trivial types
+  template <typename Fn, typename P>
+  static size_t run_end(const P* first, size_t i, size_t n,
+                        Fn bulk_op_table::*fn, Fn& op) noexcept {
+    const size_t last = n - i > max_run ? i + max_run : n;
+    op = key(first[i], fn);
+    for (i++; i < last && key(first[i], fn) == op; i++) {}
+    return i;
+  }
+  template <typename Fn, typename P>
+  static Fn key(const P& p, Fn bulk_op_table::*fn) noexcept {
+    return p.operate ? bulk_ops(p.operate.get())->*fn : nullptr;
+  }
+
+  /// default construct the handles [i, end) of d, ready for a typed run to
+  /// construct their objects
+  template <typename P>
+  static void construct_handles(P* d, size_t i, size_t end) noexcept {
+    for (; i < end; i++) {
+      new (&d[i]) P;
+    }
+  }
+  /// publish the op tables of the objects constructed in [i, end) of d
+  template <typename P>
+  static void assign_ops(P* d, const P* first, size_t i, size_t end) noexcept {
+    for (; i < end; i++) {
+      d[i].operate = first[i].operate;
+    }
+  }
+
+  template <typename T, size_t S, size_t A>
+  static void relocate(ptr<T, S, A>* first, size_t n,
+                       ptr<T, S, A>* d) noexcept {
+    using P = ptr<T, S, A>;
+#ifdef STATIC_PTR_ENABLE_OP_STATS
+    for (size_t i = 0; i < n; i++) {
+      if (first[i].operate) {
+        STATIC_PTR_RECORD_OPS(first[i].operate, move);
+      }
+    }
+#endif
+#ifdef STATIC_PTR_ENABLE_LAYOUT_STATS
+    // handles count themselves as they're constructed and destroyed
+    for (size_t i = 0; i < n; i++) {
+      new (&d[i]) P(std::move(first[i]));
+      first[i].~P();
+    }
+#else
+    if (P::trivial_relocate) {
+      if (n) {
+        std::memcpy(static_cast<void*>(d), first, n * sizeof(P));
+      }
+      return;
+    }
+    for (size_t i = 0; i < n;) {
+      decltype(bulk_op_table::relocate_n) relocate_n;
+      const size_t end = run_end(first, i, n, &bulk_op_table::relocate_n,
+                                 relocate_n);
+      // copy the handles, including their op tables, then relocate the
+      // objects over the copied bytes
+      std::memcpy(static_cast<void*>(&d[i]), &first[i],
+                  (end - i) * sizeof(P));
+      if (relocate_n) {
+        relocate_n(&d[i].buffer, &first[i].buffer, end - i, sizeof(P));
+      }
+      i = end;
+    }
+#endif
+  }
+
+  template <typename T, size_t S, size_t A>
+  static void copy(const ptr<T, S, A>* first, size_t n, ptr<T, S, A>* d) {
+    using P = ptr<T, S, A>;
+#ifdef STATIC_PTR_ENABLE_OP_STATS
+    for (size_t i = 0; i < n; i++) {
+      if (first[i].operate) {
+        STATIC_PTR_RECORD_OPS(first[i].operate, copy);
+      }
+    }
+#endif
+    // destroys the completed handles if a copy throws
+    struct guard {
+      P* d;
+      size_t done;
+      ~guard() { destroy(d, done); }
+    } g{d, 0};
+#ifdef STATIC_PTR_ENABLE_LAYOUT_STATS
+    for (; g.done < n; g.done++) {
+      new (&d[g.done]) P(first[g.done]);
+    }
+#else
+    if (P::trivial_copy) {
+      if (n) {
+        std::memcpy(static_cast<void*>(d), first, n * sizeof(P));
+      }
+      g.done = 0;
+      return;
+    }
+    while (g.done < n) {
+      const size_t i = g.done;
+      decltype(bulk_op_table::copy_construct_n) copy_construct_n;
+      const size_t end = run_end(first, i, n,
+                                 &bulk_op_table::copy_construct_n,
+                                 copy_construct_n);
+      if (copy_construct_n) {
+        // the handles are empty until their run is copied, so they need no
+        // cleanup if it throws
+        construct_handles(d, i, end);
+        copy_construct_n(&d[i].buffer, &first[i].buffer, end - i, sizeof(P));
+        assign_ops(d, first, i, end);
+      } else {
+        std::memcpy(static_cast<void*>(&d[i]), &first[i],
+                    (end - i) * sizeof(P));
+      }
+      g.done = end;
+    }
+#endif
+    g.done = 0;
+  }
+
+  template <typename T, size_t S, size_t A>
+  static void destroy(ptr<T, S, A>* first, size_t n) noexcept {
+    using P = ptr<T, S, A>;
+#ifdef STATIC_PTR_ENABLE_LAYOUT_STATS
+    for (size_t i = 0; i < n; i++) {
+      first[i].~P();
+    }
+#else
+    if (P::trivial_destruct) {
+      return;
+    }
+    for (size_t i = 0; i < n;) {
+      decltype(bulk_op_table::destruct_n) destruct_n;
+      const size_t end = run_end(first, i, n, &bulk_op_table::destruct_n,
+                                 destruct_n);
+      if (destruct_n) {
+        destruct_n(&first[i].buffer, end - i, sizeof(P));
+      }
+      i = end;
+    }
+#endif
+  }
+};
+
+} // namespace _
+
+/// move the n handles from first into the uninitialized storage at d_first,
+/// ending the lifetime of the source handles, which must not be destroyed
+/// afterwards. returns the end of the destination range
+template <typename T, size_t S, size_t A>
+static_ptr<T, S, A>* uninitialized_relocate_n(static_ptr<T, S, A>* first,
+                                              size_t n,
+                                              static_ptr<T, S, A>* d_first)
+    noexcept {
+  static_assert(is_trivially_relocatable<T>::value ||
+                _::relocater<T>::is_noexcept,
+                "uninitialized_relocate_n requires nothrow relocation");
+  _::static_ptr_range::relocate(first, n, d_first);
+  return d_first + n;
+}
+
+/// copy the n handles from first into the uninitialized storage at d_first.
+/// if a copy throws, the handles copied so far are destroyed. returns the end
+/// of the destination range
+template <typename T, size_t S, size_t A>
+static_ptr<T, S, A>* uninitialized_copy_n(const static_ptr<T, S, A>* first,
+                                          size_t n,
+                                          static_ptr<T, S, A>* d_first)
+    noexcept(std::is_trivially_copyable<T>::value ||
+             _::copy_constructer<T>::is_noexcept) {
+  static_assert(_::copy_constructer<T>::enabled,
+                "must be CopyConstructible");
+  _::static_ptr_range::copy(first, n, d_first);
+  return d_first + n;
+}
+
+/// destroy the n handles from first, leaving uninitialized storage. returns
+/// the end of the range
+template <typename T, size_t S, size_t A>
+static_ptr<T, S, A>* destroy_n(static_ptr<T, S, A>* first, size_t n) noexcept {
+  _::static_ptr_range::destroy(first, n);
+  return first + n;
+}
+
+} // namespace static_ptr
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <static_ptr/static_ptr.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+
+namespace static_ptr {
+
+namespace _ {
+
+/// random access iterator over an array of buffers holding types derived
+/// from T, yielding references to T
+template <typename T, typename Buffer>
+class buffer_iterator {
+  Buffer* p{nullptr};
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename std::remove_const<T>::type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  buffer_iterator() = default;
+  explicit buffer_iterator(Buffer* p) noexcept : p(p) {}
+  /// convert iterator to const_iterator
+  template <typename U, typename B>
+  buffer_iterator(const buffer_iterator<U, B>& o) noexcept : p(o.buffer()) {}
+
+  Buffer* buffer() const noexcept { return p; }
+
+  reference operator*() const noexcept { return *reinterpret_cast<T*>(p); }
+  pointer operator->() const noexcept { return reinterpret_cast<T*>(p); }
+  reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+  buffer_iterator& operator++() noexcept { ++p; return *this; }
+  buffer_iterator operator++(int) noexcept { return buffer_iterator{p++}; }
+  buffer_iterator& operator--() noexcept { --p; return *this; }
+  buffer_iterator operator--(int) noexcept { return buffer_iterator{p--}; }
+  buffer_iterator& operator+=(difference_type n) noexcept { p += n; return *this; }
+  buffer_iterator& operator-=(difference_type n) noexcept { p -= n; return *this; }
+
+  friend buffer_iterator operator+(buffer_iterator i, difference_type n) noexcept {
+    return i += n;
+  }
+  friend buffer_iterator operator+(difference_type n, buffer_iterator i) noexcept {
+    return i += n;
+  }
+  friend buffer_iterator operator-(buffer_iterator i, difference_type n) noexcept {
+    return i -= n;
+  }
+  friend difference_type operator-(buffer_iterator l, buffer_iterator r) noexcept {
+    return l.p - r.p;
+  }
+  friend bool operator==(buffer_iterator l, buffer_iterator r) noexcept { return l.p == r.p; }
+  friend bool operator!=(buffer_iterator l, buffer_iterator r) noexcept { return l.p != r.p; }
+  friend bool operator<(buffer_iterator l, buffer_iterator r) noexcept { return l.p < r.p; }
+  friend bool operator>(buffer_iterator l, buffer_iterator r) noexcept { return l.p > r.p; }
+  friend bool operator<=(buffer_iterator l, buffer_iterator r) noexcept { return l.p <= r.p; }
+  friend bool operator>=(buffer_iterator l, buffer_iterator r) noexcept { return l.p >= r.p; }
+};
+
+/// implementation of static_ptr_vector with all move and copy operations
+template <typename T, size_t S>
+class basic_static_ptr_vector : protected type_erasure_ops {
+  static_assert(sizeof(T) <= S, "S is too small for T");
+  static_assert(is_trivially_relocatable<T>::value ||
+                relocater<T>::is_noexcept,
+                "static_ptr_vector requires nothrow relocation");
+
+  using traits = basic_static_ptr<T, S>;
+  using buffer_type = typename traits::buffer_type;
+
+  /// arrays are aligned to cache lines
+  static constexpr size_t cache_line = 64;
+
+  /// the allocation that the arrays are aligned within
+  void* block{nullptr};
+  buffer_type* buffers{nullptr};
+  op_fn* ops{nullptr};
+  size_t count{0};
+  size_t cap{0};
+
+  static constexpr size_t round_up(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+  }
+
+  /// arrays of a given capacity that don't hold any elements yet. the
+  /// destructor frees them unless they were adopted
+  struct storage {
+    void* block;
+    buffer_type* buffers;
+    op_fn* ops;
+    size_t cap;
+
+    explicit storage(size_t cap) : cap(cap) {
+      const size_t buffers_size = round_up(cap * sizeof(buffer_type),
+                                           alignof(op_fn));
+      block = ::operator new(buffers_size + cap * sizeof(op_fn) + cache_line);
+      auto addr = reinterpret_cast<std::uintptr_t>(block);
+      buffers = reinterpret_cast<buffer_type*>(round_up(addr, cache_line));
+      ops = reinterpret_cast<op_fn*>(
+          reinterpret_cast<char*>(buffers) + buffers_size);
+    }
+    storage(const storage&) = delete;
+    storage& operator=(const storage&) = delete;
+    ~storage() { ::operator delete(block); }
+  };
+
+  /// move the elements into s and free the current arrays
+  void adopt(storage& s) noexcept {
+    if (count) {
+      relocate_n(s.buffers, buffers, ops, count);
+      std::memcpy(s.ops, ops, count * sizeof(op_fn));
+    }
+    ::operator delete(block);
+    block = s.block;
+    buffers = s.buffers;
+    ops = s.ops;
+    cap = s.cap;
+    s.block = nullptr;
+  }
+
+  /// move the elements into newly allocated arrays of the given capacity
+  void reallocate(size_t new_cap) {
+    storage s{new_cap};
+    adopt(s);
+  }
+
+  /// relocate n buffers with the given ops from src to dst
+  static void relocate_n(buffer_type* dst, buffer_type* src,
+                         const op_fn* src_ops, size_t n) noexcept {
+    if (traits::trivial_relocate) {
+      std::memcpy(dst, src, n * sizeof(buffer_type));
+      return;
+    }
+    // relocate runs of the same type with one call
+    for (size_t i = 0; i < n;) {
+      const auto relocate_n = bulk_ops(src_ops[i])->relocate_n;
+      size_t end = i + 1;
+      while (end < n && bulk_ops(src_ops[end])->relocate_n == relocate_n) {
+        end++;
+      }
+      if (relocate_n) {
+        relocate_n(&dst[i], &src[i], end - i, sizeof(buffer_type));
+      } else {
+        std::memcpy(&dst[i], &src[i], (end - i) * sizeof(buffer_type));
+      }
+      i = end;
+    }
+  }
+
+  void destroy_from(size_t first) noexcept {
+    if (!traits::trivial_destruct) {
+      for (size_t i = first; i < count;) {
+        const auto destruct_n = bulk_ops(ops[i])->destruct_n;
+        size_t end = i + 1;
+        while (end < count && bulk_ops(ops[end])->destruct_n == destruct_n) {
+          end++;
+        }
+        if (destruct_n) {
+          destruct_n(&buffers[i], end - i, sizeof(buffer_type));
+        }
+        i = end;
+      }
+    }
+    count = first;
+  }
+
+  size_t grown_capacity() const noexcept {
+    return cap ? cap * 2 : initial_capacity();
+  }
+  /// start with at least one cache line of elements
+  static constexpr size_t initial_capacity() {
+    return sizeof(buffer_type) >= cache_line ? 1 : cache_line / sizeof(buffer_type);
+  }
+
+  void append_copy(const basic_static_ptr_vector& o) {
+    reserve(o.count);
+    if (traits::trivial_copy) {
+      // the arrays of an empty vector may be null
+      if (o.count) {
+        std::memcpy(buffers, o.buffers, o.count * sizeof(buffer_type));
+        std::memcpy(ops, o.ops, o.count * sizeof(op_fn));
+      }
+      count = o.count;
+      return;
+    }
+    for (size_t i = 0; i < o.count; i++) {
+      if (auto copy_construct = o.ops[i]->copy_construct) {
+        copy_construct(&buffers[i], &o.buffers[i]);
+      } else {
+        std::memcpy(&buffers[i], &o.buffers[i], sizeof(buffer_type));
+      }
+      ops[i] = o.ops[i];
+      count = i + 1;
+    }
+  }
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = buffer_iterator<T, buffer_type>;
+  using const_iterator = buffer_iterator<const T, const buffer_type>;
+
+  basic_static_ptr_vector() = default;
+  ~basic_static_ptr_vector() {
+    clear();
+    ::operator delete(block);
+  }
+
+  basic_static_ptr_vector(basic_static_ptr_vector&& o) noexcept
+    : block(o.block), buffers(o.buffers), ops(o.ops),
+      count(o.count), cap(o.cap) {
+    o.block = nullptr;
+    o.buffers = nullptr;
+    o.ops = nullptr;
+    o.count = o.cap = 0;
+  }
+  basic_static_ptr_vector& operator=(basic_static_ptr_vector&& o) noexcept {
+    if (this != &o) {
+      clear();
+      ::operator delete(block);
+      block = o.block;
+      buffers = o.buffers;
+      ops = o.ops;
+      count = o.count;
+      cap = o.cap;
+      o.block = nullptr;
+      o.buffers = nullptr;
+      o.ops = nullptr;
+      o.count = o.cap = 0;
+    }
+    return *this;
+  }
+
+  basic_static_ptr_vector(const basic_static_ptr_vector& o)
+    : basic_static_ptr_vector() {
+    append_copy(o);
+  }
+  basic_static_ptr_vector& operator=(const basic_static_ptr_vector& o) {
+    if (this != &o) {
+      clear();
+      append_copy(o);
+    }
+    return *this;
+  }
+
+  /// construct a U at the end of the vector
+  template <typename U = T, typename ...Args>
+  U& emplace_back(Args&&... args) {
+    static_assert(sizeof(U) <= S,
+                  "size of type is larger than static size");
+    static_assert(alignof(U) <= alignof(T),
+                  "alignment of type is larger than alignment of T");
+    static_assert(std::is_base_of<T, U>::value,
+                  "initializing with incompatible type");
+    static_assert(supports_same_ops<T, U>::value,
+                  "move into static_ptr_vector with incompatible type");
+    STATIC_PTR_RECORD(U, construct);
+    if (count == cap) {
+      // construct the element in the new arrays before moving the others,
+      // so that args may refer to elements of this vector
+      storage s{grown_capacity()};
+      auto u = new (&s.buffers[count]) U(std::forward<Args>(args)...);
+      s.ops[count] = get_operate<U>();
+      adopt(s);
+      ++count;
+      return *u;
+    }
+    auto u = new (&buffers[count]) U(std::forward<Args>(args)...);
+    ops[count] = get_operate<U>();
+    ++count;
+    return *u;
+  }
+
+  void pop_back() noexcept {
+    destroy_from(count - 1);
+  }
+  void clear() noexcept {
+    destroy_from(0);
+  }
+  void reserve(size_t n) {
+    if (n > cap) {
+      reallocate(n);
+    }
+  }
+
+  size_t size() const noexcept { return count; }
+  size_t capacity() const noexcept { return cap; }
+  bool empty() const noexcept { return count == 0; }
+
+  /// identifies the dynamic type of element i, as returned by get_operate<U>()
+  op_fn type_of(size_t i) const noexcept { return ops[i]; }
+
+  T& operator[](size_t i) noexcept { return *reinterpret_cast<T*>(&buffers[i]); }
+  const T& operator[](size_t i) const noexcept {
+    return *reinterpret_cast<const T*>(&buffers[i]);
+  }
+  T& front() noexcept { return (*this)[0]; }
+  const T& front() const noexcept { return (*this)[0]; }
+  T& back() noexcept { return (*this)[count - 1]; }
+  const T& back() const noexcept { return (*this)[count - 1]; }
+
+  iterator begin() noexcept { return iterator{buffers}; }
+  iterator end() noexcept { return iterator{buffers + count}; }
+  const_iterator begin() const noexcept { return const_iterator{buffers}; }
+  const_iterator end() const noexcept { return const_iterator{buffers + count}; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+};
+
+} // namespace _
+
+/// a vector of polymorphic objects derived from T, each stored inline in a
+/// buffer of size S. the buffers are contiguous in a cache line aligned
+/// array, and the op tables live in a parallel array, so iteration is a
+/// linear scan over the objects themselves. growth relocates all elements
+/// in bulk, with a single memcpy for trivially relocatable types
+template <typename T, size_t S = sizeof(T)>
+class static_ptr_vector : public _::basic_static_ptr_vector<T, S>,
+                          _::copy_constructer<T>, _::copy_assigner<T> {
+};
+
+} // namespace static_ptr
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <static_ptr/static_function.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace static_ptr {
+
+namespace _ {
+
+/// bounded chase-lev deque of tasks stored inline in its slots. the owner
+/// thread pushes and pops at the bottom, and other threads steal from the
+/// top. unlike the classic deque of pointers, a thief claims a slot before
+/// it relocates the task out, so each slot has a sequence number that tells
+/// the owner when a thief has finished with it and it can be reused
+template <typename Task>
+class work_stealing_deque {
+  struct slot {
+    /// the index that this slot is free to be pushed at
+    std::atomic<std::int64_t> seq;
+    Task task;
+  };
+
+  /// top and bottom are written by different threads, so they're padded
+  /// onto cache lines of their own. alignas would need an over-aligned
+  /// operator new, which c++11 doesn't provide for the heap allocated workers
+  static constexpr size_t cache_line = 64;
+
+  std::unique_ptr<slot[]> slots;
+  std::int64_t mask;
+  char pad0[cache_line];
+  std::atomic<std::int64_t> top{0};
+  char pad1[cache_line];
+  std::atomic<std::int64_t> bottom{0};
+  char pad2[cache_line];
+
+  static size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+      p *= 2;
+    }
+    return p;
+  }
+
+ public:
+  /// capacity is rounded up to a power of two
+  explicit work_stealing_deque(size_t capacity)
+    : slots(new slot[round_up_pow2(capacity)]),
+      mask(static_cast<std::int64_t>(round_up_pow2(capacity)) - 1) {
+    for (std::int64_t i = 0; i <= mask; i++) {
+      slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  size_t capacity() const noexcept { return static_cast<size_t>(mask + 1); }
+
+  /// whether the deque looked empty at some point during the call
+  bool empty() const noexcept {
+    return bottom.load(std::memory_order_acquire) <=
+        top.load(std::memory_order_acquire);
+  }
+
+  /// owner only. moves t into the bottom slot, or returns false if full
+  bool push(Task& t) noexcept {
+    const std::int64_t b = bottom.load(std::memory_order_relaxed);
+    const std::int64_t t0 = top.load(std::memory_order_acquire);
+    if (b - t0 > mask) {
+      return false;
+    }
+    slot& s = slots[b & mask];
+    // a thief may still be relocating the previous task out of this slot
+    while (s.seq.load(std::memory_order_acquire) != b) {
+      std::this_thread::yield();
+    }
+    s.task = std::move(t);
+    bottom.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// owner only. moves the bottom task into t, or returns false if empty
+  bool pop(Task& t) noexcept {
+    const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t0 = top.load(std::memory_order_relaxed);
+    if (t0 > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    slot& s = slots[b & mask];
+    if (t0 == b) {
+      // the last task, so race the thieves for it
+      const bool won = top.compare_exchange_strong(
+          t0, t0 + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom.store(b + 1, std::memory_order_relaxed);
+      if (!won) {
+        return false;
+      }
+      t = std::move(s.task);
+      // taken from the top, so the slot is next pushed a lap later
+      s.seq.store(b + mask + 1, std::memory_order_release);
+      return true;
+    }
+    // taken from the bottom, so the slot is next pushed at the same index
+    t = std::move(s.task);
+    return true;
+  }
+
+  /// any thread. moves the top task into t, or returns false if the deque
+  /// was empty or another thread took the task first
+  bool steal(Task& t) noexcept {
+    std::int64_t t0 = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t b = bottom.load(std::memory_order_acquire);
+    if (t0 >= b) {
+      return false;
+    }
+    if (!top.compare_exchange_strong(t0, t0 + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      return false;
+    }
+    slot& s = slots[t0 & mask];
+    t = std::move(s.task);
+    s.seq.store(t0 + mask + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+} // namespace _
+
+/// a thread pool that runs move-only tasks of size up to S, stored inline
+/// in move_only_static_functions, so submitting and running a task never
+/// allocates. each worker has a work-stealing deque: tasks submitted from a
+/// worker go to its own deque, and tasks submitted from other threads go to
+/// a bounded injection queue. idle workers steal from the other deques. when
+/// the queues are full, submit() runs the task on the calling thread.
+/// destruction finishes all queued tasks before joining the workers. tasks
+/// must not throw
+template <size_t S = 64>
+class static_thread_pool {
+ public:
+  using task = move_only_static_function<void(), S>;
+
+ private:
+  struct worker {
+    _::work_stealing_deque<task> deque;
+    std::thread thread;
+    explicit worker(size_t capacity) : deque(capacity) {}
+  };
+  std::vector<std::unique_ptr<worker>> workers;
+
+  /// guards the injection queue and stopping, and is held by workers while
+  /// they decide to sleep
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable idle;
+
+  /// ring of tasks submitted from outside the pool
+  std::vector<task> injected;
+  size_t inject_head{0};
+  size_t inject_count{0};
+  /// inject_count, for workers to check without the lock
+  std::atomic<size_t> injected_size{0};
+
+  /// tasks submitted but not yet finished
+  std::atomic<size_t> pending{0};
+  std::atomic<size_t> sleepers{0};
+  bool stopping{false};
+
+  /// the pool and index of the worker running on this thread, if any
+  struct current_worker {
+    const static_thread_pool* pool;
+    size_t index;
+  };
+  static current_worker& this_worker() {
+    static thread_local current_worker w{nullptr, 0};
+    return w;
+  }
+
+  bool take_injected(task& t) {
+    if (injected_size.load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock{mutex};
+    if (inject_count == 0) {
+      return false;
+    }
+    t = std::move(injected[inject_head]);
+    inject_head = (inject_head + 1) % injected.size();
+    injected_size.store(--inject_count, std::memory_order_release);
+    return true;
+  }
+
+  bool find_task(size_t index, task& t, std::uint32_t& rng) {
+    if (workers[index]->deque.pop(t) || take_injected(t)) {
+      return true;
+    }
+    // steal, starting from a random victim
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    const size_t n = workers.size();
+    const size_t start = rng % n;
+    for (size_t i = 0; i < n; i++) {
+      const size_t victim = (start + i) % n;
+      if (victim != index && workers[victim]->deque.steal(t)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// with the lock held
+  bool has_work() const {
+    if (inject_count) {
+      return true;
+    }
+    for (auto& w : workers) {
+      if (!w->deque.empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run(task& t) {
+    t();
+    t = nullptr;
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> lock{mutex};
+      idle.notify_all();
+    }
+  }
+
+  /// wake a sleeping worker after publishing a task to a deque
+  void notify() {
+    // pairs with the fence in worker_loop, so either the worker sees the
+    // task or this sees the worker
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock{mutex};
+      wake.notify_one();
+    }
+  }
+
+  void worker_loop(size_t index) {
+    this_worker() = current_worker{this, index};
+    std::uint32_t rng = static_cast<std::uint32_t>(index) * 2654435761u + 1;
+    task t;
+    for (;;) {
+      if (find_task(index, t, rng)) {
+        run(t);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock{mutex};
+      sleepers.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!stopping && !has_work()) {
+        wake.wait(lock);
+      }
+      sleepers.fetch_sub(1, std::memory_order_relaxed);
+      if (stopping && !has_work()) {
+        return;
+      }
+    }
+  }
+
+ public:
+  /// start threads workers, each with a deque of queue_capacity tasks. the
+  /// injection queue also holds queue_capacity tasks
+  explicit static_thread_pool(
+      size_t threads = std::thread::hardware_concurrency(),
+      size_t queue_capacity = 1024)
+    : injected(queue_capacity ? queue_capacity : 1) {
+    if (threads == 0) {
+      threads = 1;
+    }
+    for (size_t i = 0; i < threads; i++) {
+      workers.emplace_back(new worker(queue_capacity));
+    }
+    for (size_t i = 0; i < threads; i++) {
+      workers[i]->thread = std::thread{&static_thread_pool::worker_loop,
+                                       this, i};
+    }
+  }
+
+  ~static_thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto& w : workers) {
+      w->thread.join();
+    }
+  }
+
+  static_thread_pool(const static_thread_pool&) = delete;
+  static_thread_pool& operator=(const static_thread_pool&) = delete;
+
+  size_t size() const noexcept { return workers.size(); }
+
+  /// queue the callable f to run on a worker
+  template <typename F>
+  void submit(F&& f) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    task t{std::forward<F>(f)};
+    const auto& w = this_worker();
+    if (w.pool == this && workers[w.index]->deque.push(t)) {
+      notify();
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (inject_count < injected.size()) {
+        injected[(inject_head + inject_count) % injected.size()] = std::move(t);
+        injected_size.store(++inject_count, std::memory_order_release);
+        if (sleepers.load(std::memory_order_relaxed)) {
+          wake.notify_one();
+        }
+        return;
+      }
+    }
+    // the queues are full, so run it here
+    run(t);
+  }
+
+  /// block until all submitted tasks have finished
+  void wait() {
+    std::unique_lock<std::mutex> lock{mutex};
+    while (pending.load(std::memory_order_acquire) != 0) {
+      idle.wait(lock);
+    }
+  }
+};
+
+} // namespace static_ptr
@@ -0,0 +1,51 @@
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+using static_ptr::_::op_table_for;
+using static_ptr::_::disabled_ops;
+
+static void print_handler(const char* what)
+{
+  std::fprintf(stderr, "handled: %s\n", what);
+}
+
+TEST(AbortHandler, Set)
+{
+  ASSERT_EQ(nullptr, static_ptr::set_abort_handler(&print_handler));
+  ASSERT_EQ(&print_handler, static_ptr::set_abort_handler(nullptr));
+  ASSERT_EQ(nullptr, static_ptr::set_abort_handler(nullptr));
+}
+
+TEST(AbortHandler, Abort)
+{
+  ASSERT_DEATH(static_ptr::_::abort_with("failed"), "static_ptr: failed");
+  ASSERT_DEATH({
+    static_ptr::set_abort_handler(&print_handler);
+    static_ptr::_::abort_with("failed");
+  }, "handled: failed");
+}
+
+struct move_only {
+  std::unique_ptr<int> p;
+};
+
+TEST(AbortHandler, DisabledOps)
+{
+  // operations that a type lacks share one table entry
+  using ops = op_table_for<move_only>;
+  ASSERT_EQ(&disabled_ops::copy_construct, ops::table.copy_construct);
+  ASSERT_EQ(&disabled_ops::copy_assign, ops::table.copy_assign);
+  ASSERT_EQ(&disabled_ops::copy_construct_n, ops::table.copy_construct_n);
+  ASSERT_NE(nullptr, ops::table.relocate);
+  ASSERT_NE(&disabled_ops::relocate, ops::table.relocate);
+
+  move_only a, b;
+#ifdef STATIC_PTR_NO_EXCEPTIONS
+  ASSERT_DEATH(ops::table.copy_construct(&a, &b), "copy constructor disabled");
+#else
+  ASSERT_THROW(ops::table.copy_construct(&a, &b), std::logic_error);
+#endif
+}
@@ -0,0 +1,103 @@
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+
+template <typename T>
+using in_place_t = static_ptr::in_place_t<T>;
+
+struct base {
+  virtual ~base() = default;
+  virtual float sum() const { return 0; }
+};
+
+// over-aligned types like those holding SIMD vectors
+struct alignas(32) vec8 : base {
+  float v[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  float sum() const override {
+    float s = 0;
+    for (auto f : v) s += f;
+    return s;
+  }
+};
+struct alignas(64) vec16 : base {
+  float v[16] = {};
+  float sum() const override { return 16; }
+};
+
+template <typename T>
+bool is_aligned(const T* p, size_t a)
+{
+  return reinterpret_cast<std::uintptr_t>(p) % a == 0;
+}
+
+using base_ptr = static_ptr::static_ptr<base, sizeof(vec16), alignof(vec16)>;
+using vec8_ptr = static_ptr::static_ptr<base, sizeof(vec16), alignof(vec8)>;
+using small_ptr = static_ptr::static_ptr<base, sizeof(vec16)>;
+
+TEST(AlignedPtr, Layout)
+{
+  ASSERT_EQ(64u, alignof(base_ptr));
+  ASSERT_EQ(0u, sizeof(base_ptr) % 64);
+  ASSERT_EQ(alignof(base), alignof(small_ptr));
+}
+
+TEST(AlignedPtr, OverAligned)
+{
+  auto a = base_ptr::make<vec8>();
+  ASSERT_TRUE(is_aligned(a.get(), 32));
+  ASSERT_EQ(36, a->sum());
+  auto b = base_ptr::make<vec16>();
+  ASSERT_TRUE(is_aligned(b.get(), 64));
+  ASSERT_EQ(16, b->sum());
+  b.emplace<vec8>();
+  ASSERT_EQ(36, b->sum());
+}
+
+TEST(AlignedPtr, MoveCopy)
+{
+  // std::allocator only honors extended alignment since c++17, so these
+  // live on the stack
+  base_ptr v[4];
+  for (auto& p : v) {
+    p = base_ptr::make<vec8>();
+  }
+  for (auto& p : v) {
+    ASSERT_TRUE(is_aligned(p.get(), 64));
+    ASSERT_EQ(36, p->sum());
+  }
+  base_ptr c{v[3]};
+  ASSERT_EQ(36, c->sum());
+  base_ptr d;
+  d = std::move(c);
+  ASSERT_EQ(36, d->sum());
+}
+
+TEST(AlignedPtr, Conversion)
+{
+  ASSERT_TRUE((std::is_constructible<base_ptr, vec8_ptr&&>::value));
+  ASSERT_TRUE((std::is_constructible<base_ptr, const vec8_ptr&>::value));
+  ASSERT_TRUE((std::is_assignable<base_ptr, vec8_ptr&&>::value));
+  ASSERT_FALSE((std::is_constructible<vec8_ptr, base_ptr&&>::value));
+  ASSERT_FALSE((std::is_constructible<small_ptr, const vec8_ptr&>::value));
+  ASSERT_FALSE((std::is_assignable<small_ptr, vec8_ptr&&>::value));
+
+  base_ptr a{vec8_ptr::make<vec8>()};
+  ASSERT_TRUE(is_aligned(a.get(), 32));
+  ASSERT_EQ(36, a->sum());
+}
+
+// per-thread slot padded to a cache line to avoid false sharing
+struct counter {
+  long value = 0;
+};
+using counter_slot = static_ptr::static_ptr<counter, 64 - sizeof(void*), 64>;
+
+TEST(AlignedPtr, CacheLineSlot)
+{
+  ASSERT_EQ(64u, sizeof(counter_slot));
+  counter_slot slots[4];
+  for (auto& s : slots) {
+    s.emplace();
+    ASSERT_TRUE(is_aligned(s.get(), 64));
+  }
+}
@@ -0,0 +1,106 @@
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+using namespace static_ptr::_;
+
+// the mask agrees with the standard traits it replaces
+template <typename T>
+static void expect_std_traits()
+{
+  const unsigned caps = capabilities<T>::value;
+  EXPECT_EQ(std::is_default_constructible<T>::value,
+            !!(caps & cap_default_construct));
+  EXPECT_EQ(std::is_nothrow_default_constructible<T>::value,
+            !!(caps & cap_nothrow_default_construct));
+  EXPECT_EQ(std::is_move_constructible<T>::value,
+            !!(caps & cap_move_construct));
+  EXPECT_EQ(std::is_nothrow_move_constructible<T>::value,
+            !!(caps & cap_nothrow_move_construct));
+  EXPECT_EQ(std::is_move_assignable<T>::value,
+            !!(caps & cap_move_assign));
+  EXPECT_EQ(std::is_nothrow_move_assignable<T>::value,
+            !!(caps & cap_nothrow_move_assign));
+  EXPECT_EQ(std::is_copy_constructible<T>::value,
+            !!(caps & cap_copy_construct));
+  EXPECT_EQ(std::is_nothrow_copy_constructible<T>::value,
+            !!(caps & cap_nothrow_copy_construct));
+  EXPECT_EQ(std::is_copy_assignable<T>::value,
+            !!(caps & cap_copy_assign));
+  EXPECT_EQ(std::is_nothrow_copy_assignable<T>::value,
+            !!(caps & cap_nothrow_copy_assign));
+  EXPECT_EQ(std::is_destructible<T>::value, !!(caps & cap_destruct));
+  EXPECT_EQ(std::is_nothrow_destructible<T>::value,
+            !!(caps & cap_nothrow_destruct));
+  EXPECT_EQ(std::is_trivially_destructible<T>::value,
+            !!(caps & cap_trivially_destructible));
+  EXPECT_EQ(std::is_trivially_copyable<T>::value,
+            !!(caps & cap_trivially_copyable));
+  EXPECT_EQ(static_ptr::is_trivially_relocatable<T>::value,
+            !!(caps & cap_trivially_relocatable));
+}
+
+struct trivial { int i; };
+struct abstract {
+  virtual ~abstract() {}
+  virtual void f() = 0;
+};
+struct throwing_dtor {
+  ~throwing_dtor() noexcept(false) {}
+};
+struct private_dtor {
+ private:
+  ~private_dtor() {}
+};
+struct move_only {
+  move_only() = default;
+  move_only(move_only&&) = default;
+  move_only& operator=(move_only&&) = default;
+};
+struct throwing_copy {
+  throwing_copy() = default;
+  throwing_copy(const throwing_copy&) {}
+  throwing_copy& operator=(const throwing_copy&) { return *this; }
+};
+struct relocatable {
+  relocatable() {}
+  relocatable(const relocatable&) {}
+  ~relocatable() {}
+};
+
+namespace static_ptr {
+template <> struct is_trivially_relocatable<relocatable> : std::true_type {};
+} // namespace static_ptr
+
+TEST(Capabilities, MatchStdTraits)
+{
+  expect_std_traits<int>();
+  expect_std_traits<trivial>();
+  expect_std_traits<const trivial>();
+  expect_std_traits<abstract>();
+  expect_std_traits<throwing_dtor>();
+  expect_std_traits<private_dtor>();
+  expect_std_traits<move_only>();
+  expect_std_traits<throwing_copy>();
+  expect_std_traits<relocatable>();
+  expect_std_traits<std::string>();
+  expect_std_traits<std::unique_ptr<int>>();
+}
+
+struct base {
+  virtual ~base() {}
+};
+struct derived : base {};
+struct derived_move_only : base {
+  derived_move_only() = default;
+  derived_move_only(derived_move_only&&) = default;
+};
+
+TEST(Capabilities, SupportsSameOps)
+{
+  ASSERT_TRUE((supports_same_ops<base, derived>::value));
+  ASSERT_FALSE((supports_same_ops<base, derived_move_only>::value));
+  ASSERT_TRUE((supports_same_ops<derived_move_only, base>::value));
+  ASSERT_TRUE((supports_same_ops<relocatable, relocatable>::value));
+}
@@ -0,0 +1,132 @@
+#include <static_ptr/closed_static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+template <typename T>
+using in_place_t = static_ptr::in_place_t<T>;
+
+struct base {
+  virtual ~base() = default;
+  virtual std::string get_name() const { return "base"; }
+};
+struct derived1 : base {
+  std::string get_name() const override { return "derived1"; }
+};
+struct derived2 : base {
+  const char* name = "derived2";
+  std::string get_name() const override { return name; }
+};
+
+using base_ptr = static_ptr::closed_static_ptr<base, derived1, derived2>;
+
+// visitor that reports the static type it was called with
+struct name_of {
+  std::string operator()(const derived1&) const { return "static derived1"; }
+  std::string operator()(const derived2& d) const {
+    return std::string{"static "} + d.name;
+  }
+};
+
+TEST(ClosedStaticPtr, Layout)
+{
+  ASSERT_EQ(sizeof(derived2), base_ptr::size);
+  ASSERT_EQ(alignof(derived2), base_ptr::alignment);
+  ASSERT_EQ(0u, base_ptr::index_of<base>());
+  ASSERT_EQ(1u, base_ptr::index_of<derived1>());
+  ASSERT_EQ(2u, base_ptr::index_of<derived2>());
+}
+
+// non-polymorphic types leave padding at the end of the buffer
+struct tagged { char tag; };
+struct tagged3 : tagged { char data[2]; };
+struct tagged5 : tagged { char data[4]; };
+
+TEST(ClosedStaticPtr, IndexInPadding)
+{
+  using ptr = static_ptr::closed_static_ptr<tagged, tagged3, tagged5>;
+  ASSERT_EQ(sizeof(tagged5) + 1, sizeof(ptr));
+  using aligned_ptr = static_ptr::closed_static_ptr<base, derived1>;
+  ASSERT_EQ(sizeof(derived1) + alignof(derived1), sizeof(aligned_ptr));
+}
+
+TEST(ClosedStaticPtr, Construct)
+{
+  base_ptr p;
+  ASSERT_FALSE(p);
+  ASSERT_EQ(nullptr, p.get());
+  ASSERT_EQ(0u, p.type_index());
+
+  base_ptr q{in_place_t<derived2>{}};
+  ASSERT_TRUE(q);
+  ASSERT_TRUE(q.holds<derived2>());
+  ASSERT_FALSE(q.holds<derived1>());
+  ASSERT_EQ("derived2", q->get_name());
+
+  auto r = base_ptr::make<derived1>();
+  ASSERT_EQ("derived1", r->get_name());
+  r.emplace<derived2>();
+  ASSERT_EQ(2u, r.type_index());
+  r.reset();
+  ASSERT_FALSE(r);
+}
+
+TEST(ClosedStaticPtr, Visit)
+{
+  auto p = base_ptr::make<derived1>();
+  ASSERT_EQ("static derived1", p.visit(name_of{}));
+  p.emplace<derived2>();
+  ASSERT_EQ("static derived2", p.visit(name_of{}));
+  const base_ptr& c = p;
+  ASSERT_EQ("static derived2", c.visit(name_of{}));
+
+  // visit with mutable access
+  struct rename {
+    void operator()(derived1&) const {}
+    void operator()(derived2& d) const { d.name = "renamed"; }
+  };
+  p.visit(rename{});
+  ASSERT_EQ("renamed", p->get_name());
+}
+
+TEST(ClosedStaticPtr, MoveCopy)
+{
+  auto a = base_ptr::make<derived2>();
+  a.visit([] (base& b) { static_cast<derived2&>(b).name = "moved"; });
+  base_ptr b{std::move(a)};
+  ASSERT_FALSE(a);
+  ASSERT_EQ("moved", b->get_name());
+
+  base_ptr c{b};
+  ASSERT_EQ("moved", c->get_name());
+  ASSERT_EQ("moved", b->get_name());
+
+  auto d = base_ptr::make<derived1>();
+  d = c;
+  ASSERT_TRUE(d.holds<derived2>());
+  ASSERT_EQ("moved", d->get_name());
+
+  d = base_ptr::make<derived1>();
+  ASSERT_TRUE(d.holds<derived1>());
+  d = std::move(c);
+  ASSERT_FALSE(c);
+  ASSERT_EQ("moved", d->get_name());
+}
+
+// destruction dispatches to the stored type
+struct counted : base {
+  int* count = nullptr;
+  counted() = default;
+  explicit counted(int* count) : count(count) {}
+  ~counted() { ++*count; }
+};
+
+TEST(ClosedStaticPtr, Destroy)
+{
+  int count = 0;
+  {
+    static_ptr::closed_static_ptr<base, derived1, counted> p{
+        in_place_t<counted>{}, &count};
+    ASSERT_EQ(0, count);
+  }
+  ASSERT_EQ(1, count);
+}
@@ -0,0 +1,59 @@
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+
+// built as c++20, where static_ptrs of trivially copyable literal types can
+// be constant-initialized
+
+struct config {
+  int port = 0;
+  int threads = 0;
+  constexpr config() = default;
+  constexpr config(int port, int threads) : port(port), threads(threads) {}
+};
+struct timeout_config : config {
+  int timeout = 0;
+  constexpr timeout_config() = default;
+  constexpr timeout_config(int port, int threads, int timeout)
+    : config(port, threads), timeout(timeout) {}
+};
+
+using config_ptr = static_ptr::static_ptr<config, sizeof(timeout_config)>;
+
+constinit config_ptr empty_config;
+constinit config_ptr base_config = config_ptr::make(80, 2);
+constinit config_ptr global_config = config_ptr::make<timeout_config>(443, 4, 30);
+constinit auto free_config =
+    static_ptr::make_static_ptr<config, sizeof(timeout_config), timeout_config>(
+        8080, 8, 60);
+
+TEST(ConstexprPtr, Empty)
+{
+  ASSERT_FALSE(empty_config);
+  empty_config.emplace<timeout_config>(1, 1, 1);
+  ASSERT_EQ(1, empty_config->port);
+  empty_config.reset();
+}
+
+TEST(ConstexprPtr, ConstantInitialized)
+{
+  ASSERT_TRUE(base_config);
+  ASSERT_EQ(80, base_config->port);
+  ASSERT_EQ(2, base_config->threads);
+
+  ASSERT_EQ(443, global_config->port);
+  ASSERT_EQ(30, static_cast<const timeout_config&>(*global_config).timeout);
+
+  ASSERT_EQ(8080, free_config->port);
+  ASSERT_EQ(60, static_cast<const timeout_config&>(*free_config).timeout);
+}
+
+TEST(ConstexprPtr, CopyFromConstant)
+{
+  config_ptr p{global_config};
+  ASSERT_EQ(443, p->port);
+  p = base_config;
+  ASSERT_EQ(80, p->port);
+  // runtime construction still uses placement new
+  auto q = config_ptr::make<timeout_config>(1, 2, 3);
+  ASSERT_EQ(3, static_cast<const timeout_config&>(*q).timeout);
+}
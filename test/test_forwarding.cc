@@ -0,0 +1,108 @@
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+
+template <typename T>
+using in_place_t = static_ptr::in_place_t<T>;
+
+// argument type that counts how often it gets copied and moved
+struct counted {
+  static int copies;
+  static int moves;
+  static void clear() { copies = moves = 0; }
+  counted() = default;
+  counted(const counted&) { ++copies; }
+  counted(counted&&) noexcept { ++moves; }
+};
+int counted::copies = 0;
+int counted::moves = 0;
+
+// stores its argument by value
+struct holder {
+  counted c;
+  explicit holder(const counted& c) : c(c) {}
+  explicit holder(counted&& c) noexcept : c(std::move(c)) {}
+};
+
+// takes a move-only argument
+struct unique_holder {
+  std::unique_ptr<int> p;
+  explicit unique_holder(std::unique_ptr<int> p) noexcept : p(std::move(p)) {}
+};
+
+using holder_ptr = static_ptr::static_ptr<holder>;
+using unique_holder_ptr = static_ptr::static_ptr<unique_holder>;
+
+TEST(Forwarding, InPlaceLvalue)
+{
+  counted::clear();
+  counted c;
+  holder_ptr p{in_place_t<holder>{}, c};
+  ASSERT_EQ(1, counted::copies);
+  ASSERT_EQ(0, counted::moves);
+}
+
+TEST(Forwarding, InPlaceRvalue)
+{
+  counted::clear();
+  holder_ptr p{in_place_t<holder>{}, counted{}};
+  ASSERT_EQ(0, counted::copies);
+  ASSERT_EQ(1, counted::moves);
+}
+
+TEST(Forwarding, Emplace)
+{
+  counted::clear();
+  holder_ptr p;
+  counted c;
+  p.emplace(c);
+  ASSERT_EQ(1, counted::copies);
+  ASSERT_EQ(0, counted::moves);
+  p.emplace(std::move(c));
+  ASSERT_EQ(1, counted::copies);
+  ASSERT_EQ(1, counted::moves);
+}
+
+// the factories return by value, so the returned static_ptr itself may be
+// moved before c++17. only count copies of the argument here
+TEST(Forwarding, Make)
+{
+  counted::clear();
+  counted c;
+  auto p = holder_ptr::make(c);
+  ASSERT_EQ(1, counted::copies);
+  auto q = holder_ptr::make(counted{});
+  ASSERT_EQ(1, counted::copies);
+}
+
+TEST(Forwarding, MakeStaticPtr)
+{
+  counted::clear();
+  counted c;
+  auto p = static_ptr::make_static_ptr<holder, sizeof(holder), holder>(c);
+  ASSERT_EQ(1, counted::copies);
+  auto q = static_ptr::make_static_ptr<holder, sizeof(holder), holder>(std::move(c));
+  ASSERT_EQ(1, counted::copies);
+}
+
+TEST(Forwarding, MoveOnly)
+{
+  unique_holder_ptr a{in_place_t<unique_holder>{}, std::unique_ptr<int>{new int{1}}};
+  ASSERT_EQ(1, *a->p);
+  a.emplace(std::unique_ptr<int>{new int{2}});
+  ASSERT_EQ(2, *a->p);
+  auto b = unique_holder_ptr::make(std::unique_ptr<int>{new int{3}});
+  ASSERT_EQ(3, *b->p);
+}
+
+TEST(Forwarding, Noexcept)
+{
+  counted c;
+  ASSERT_TRUE(noexcept(holder_ptr{in_place_t<holder>{}, std::move(c)}));
+  ASSERT_FALSE(noexcept(holder_ptr{in_place_t<holder>{}, c}));
+  holder_ptr p;
+  ASSERT_TRUE(noexcept(p.emplace(std::move(c))));
+  ASSERT_FALSE(noexcept(p.emplace(c)));
+  ASSERT_TRUE(noexcept(holder_ptr::make(std::move(c))));
+  ASSERT_FALSE(noexcept(holder_ptr::make(c)));
+}
@@ -304,3 +304,37 @@ TEST(PtrDeletedMoveAssign, MoveConstructible)
   base_deleted_move_assign_ptr a{in_place_t<derived_deleted_move_assign>{}};
   base_deleted_move_assign_ptr b{std::move(a)};
 }
+
+struct pod { int value; };
+struct counted {
+  static int count;
+  int value = 7;
+  counted() { ++count; }
+  counted(const counted& o) : value(o.value) { ++count; }
+  counted& operator=(const counted&) = default;
+  ~counted() { --count; }
+};
+int counted::count = 0;
+
+TEST(PtrSelfAssign, Trivial)
+{
+  static_ptr::static_ptr<pod> a{in_place_t<pod>{}, pod{5}};
+  auto& self = a;
+  a = self;
+  ASSERT_TRUE(a);
+  ASSERT_EQ(5, a->value);
+}
+
+TEST(PtrSelfAssign, NonTrivial)
+{
+  counted::count = 0;
+  {
+    static_ptr::static_ptr<counted> a{in_place_t<counted>{}};
+    auto& self = a;
+    a = self;
+    ASSERT_TRUE(a);
+    ASSERT_EQ(7, a->value);
+    ASSERT_EQ(1, counted::count);
+  }
+  ASSERT_EQ(0, counted::count);
+}
@@ -0,0 +1,143 @@
+#define STATIC_PTR_ENABLE_OP_STATS
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using static_ptr::op_event;
+using static_ptr::op_stats;
+template <typename T>
+using in_place = static_ptr::in_place_t<T>;
+
+struct base {
+  int value = 0;
+  base() = default;
+  explicit base(int value) : value(value) {}
+  base(const base& o) noexcept : value(o.value) {}
+  base& operator=(const base& o) noexcept { value = o.value; return *this; }
+  virtual ~base() {}
+};
+struct derived_a : base {
+  using base::base;
+};
+struct derived_b : base {
+  using base::base;
+};
+
+// only movable by default construct + move assign
+struct assign_only {
+  int value = 0;
+  assign_only() = default;
+  explicit assign_only(int value) : value(value) {}
+  assign_only(assign_only&&) = delete;
+  assign_only& operator=(assign_only&&) = default;
+  ~assign_only() {}
+};
+// only move assignable by destruct + move construct
+struct construct_only {
+  const int value;
+  explicit construct_only(int value) : value(value) {}
+  construct_only(construct_only&&) = default;
+  ~construct_only() {}
+};
+
+struct trivial {
+  int value;
+};
+
+template <typename T>
+static unsigned long long count(op_event e)
+{
+  return op_stats::get<T>().count(e);
+}
+
+TEST(OpStats, ConstructMoveCopy)
+{
+  op_stats::reset();
+  using ptr = static_ptr::static_ptr<base, sizeof(derived_a)>;
+  ptr p{in_place<derived_a>{}, 1};
+  ASSERT_EQ(1u, count<derived_a>(op_event::construct));
+  ptr q{std::move(p)};
+  ASSERT_EQ(1u, count<derived_a>(op_event::move));
+  ptr r{q};
+  ASSERT_EQ(1u, count<derived_a>(op_event::copy));
+  r = q;
+  ASSERT_EQ(2u, count<derived_a>(op_event::copy));
+  ASSERT_EQ(0u, count<derived_a>(op_event::cross_type_assign));
+}
+
+TEST(OpStats, CrossTypeAssign)
+{
+  op_stats::reset();
+  using ptr = static_ptr::static_ptr<base, sizeof(derived_a)>;
+  ptr a{in_place<derived_a>{}, 1};
+  ptr b{in_place<derived_b>{}, 2};
+  a = b;
+  ASSERT_EQ(1u, count<derived_b>(op_event::cross_type_assign));
+  ASSERT_EQ(1u, count<derived_b>(op_event::copy));
+  ptr c{in_place<derived_a>{}, 3};
+  a = std::move(c);
+  ASSERT_EQ(1u, count<derived_a>(op_event::cross_type_assign));
+  ASSERT_EQ(1u, count<derived_a>(op_event::move));
+}
+
+TEST(OpStats, TrivialPaths)
+{
+  op_stats::reset();
+  using ptr = static_ptr::static_ptr<trivial>;
+  ptr p{in_place<trivial>{}, trivial{1}};
+  ptr q{std::move(p)};
+  ptr r{q};
+  ASSERT_EQ(1u, count<trivial>(op_event::construct));
+  ASSERT_EQ(1u, count<trivial>(op_event::move));
+  ASSERT_EQ(1u, count<trivial>(op_event::copy));
+}
+
+TEST(OpStats, Fallbacks)
+{
+  op_stats::reset();
+  static_ptr::static_ptr<assign_only> a{in_place<assign_only>{}, 1};
+  static_ptr::static_ptr<assign_only> a2{std::move(a)};
+  ASSERT_EQ(1u, count<assign_only>(op_event::move_construct_fallback));
+  ASSERT_EQ(1, a2->value);
+
+  static_ptr::static_ptr<construct_only> c{in_place<construct_only>{}, 2};
+  static_ptr::static_ptr<construct_only> c2{in_place<construct_only>{}, 3};
+  c2 = std::move(c);
+  ASSERT_EQ(1u, count<construct_only>(op_event::move_assign_fallback));
+  ASSERT_EQ(2, c2->value);
+}
+
+static unsigned long long hook_calls = 0;
+static const std::type_info* hook_type = nullptr;
+
+TEST(OpStats, Hook)
+{
+  auto previous = op_stats::set_hook(
+      [] (const static_ptr::type_stats& s, op_event e) {
+        if (e == op_event::construct) {
+          hook_calls++;
+          hook_type = &s.type();
+        }
+      });
+  auto p = static_ptr::static_ptr<base, sizeof(derived_b)>::make<derived_b>(1);
+  op_stats::set_hook(previous);
+  ASSERT_EQ(1u, hook_calls);
+  ASSERT_EQ(typeid(derived_b), *hook_type);
+}
+
+TEST(OpStats, Dump)
+{
+  op_stats::reset();
+  auto p = static_ptr::static_ptr<base, sizeof(derived_a)>::make<derived_a>(1);
+  std::ostringstream out;
+  op_stats::dump(out);
+  const auto text = out.str();
+  ASSERT_NE(std::string::npos, text.find(typeid(derived_a).name()));
+  ASSERT_NE(std::string::npos, text.find("construct=1"));
+
+  bool found = false;
+  op_stats::for_each([&found] (const static_ptr::type_stats& s) {
+    found |= s.type() == typeid(derived_a);
+  });
+  ASSERT_TRUE(found);
+}
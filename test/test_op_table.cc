@@ -0,0 +1,100 @@
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+template <typename T>
+using in_place_t = static_ptr::in_place_t<T>;
+
+using static_ptr::_::op_table;
+using static_ptr::_::type_erasure_ops;
+
+struct pod { int i; };
+
+struct base {
+  virtual ~base() = default;
+  virtual const char* get_name() const { return "base"; }
+};
+struct derived : base {
+  int i = 0;
+  const char* get_name() const override { return "derived"; }
+};
+
+// hot type that embeds its op table in each handle
+struct hot_base {
+  virtual ~hot_base() = default;
+  virtual int get() const { return 0; }
+};
+struct hot_derived : hot_base {
+  int value = 42;
+  int get() const override { return value; }
+};
+
+namespace static_ptr {
+template <> struct use_inline_op_table<hot_base> : std::true_type {};
+} // namespace static_ptr
+
+using base_ptr = static_ptr::static_ptr<base, sizeof(derived)>;
+using hot_ptr = static_ptr::static_ptr<hot_base, sizeof(hot_derived)>;
+
+TEST(OpTable, TrivialEntriesAreNull)
+{
+  const op_table* ops = type_erasure_ops::get_operate<pod>();
+  ASSERT_EQ(ops, ops->id);
+  ASSERT_EQ(sizeof(pod), ops->size);
+  ASSERT_EQ(nullptr, ops->relocate);
+  ASSERT_EQ(nullptr, ops->relocate_assign);
+  ASSERT_EQ(nullptr, ops->copy_construct);
+  ASSERT_EQ(nullptr, ops->copy_assign);
+  ASSERT_EQ(nullptr, ops->destruct);
+}
+
+TEST(OpTable, NonTrivialEntries)
+{
+  const op_table* ops = type_erasure_ops::get_operate<std::string>();
+  ASSERT_EQ(ops, ops->id);
+  ASSERT_EQ(sizeof(std::string), ops->size);
+  ASSERT_NE(nullptr, ops->relocate);
+  ASSERT_NE(nullptr, ops->relocate_assign);
+  ASSERT_NE(nullptr, ops->copy_construct);
+  ASSERT_NE(nullptr, ops->copy_assign);
+  ASSERT_NE(nullptr, ops->destruct);
+}
+
+TEST(OpTable, PerTypeIdentity)
+{
+  ASSERT_EQ(type_erasure_ops::get_operate<derived>(),
+            type_erasure_ops::get_operate<const derived&>());
+  ASSERT_NE(type_erasure_ops::get_operate<base>(),
+            type_erasure_ops::get_operate<derived>());
+}
+
+TEST(OpTable, InlinePolicy)
+{
+  ASSERT_EQ(sizeof(hot_ptr) - sizeof(hot_derived),
+            sizeof(op_table));
+  auto a = hot_ptr::make<hot_derived>();
+  ASSERT_EQ(42, a->get());
+  hot_ptr b{std::move(a)};
+  ASSERT_FALSE(a);
+  ASSERT_EQ(42, b->get());
+  hot_ptr c{b};
+  ASSERT_EQ(42, c->get());
+  c = hot_ptr::make<hot_base>();
+  ASSERT_EQ(0, c->get());
+  c = b;
+  ASSERT_EQ(42, c->get());
+  c.reset();
+  ASSERT_FALSE(c);
+}
+
+TEST(OpTable, PointerPolicy)
+{
+  auto a = base_ptr::make<derived>();
+  base_ptr b;
+  b = std::move(a);
+  ASSERT_STREQ("derived", b->get_name());
+  base_ptr c{b};
+  ASSERT_STREQ("derived", c->get_name());
+  c = base_ptr::make<base>();
+  ASSERT_STREQ("base", c->get_name());
+}
@@ -0,0 +1,182 @@
+#include <static_ptr/poly_collection.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+struct base {
+  virtual ~base() = default;
+  virtual int get() const { return 1; }
+};
+struct derived final : base {
+  int value = 0;
+  derived() = default;
+  explicit derived(int value) : value(value) {}
+  int get() const override { return value; }
+};
+struct derived2 final : base {
+  int get() const override { return 2; }
+};
+
+using collection = static_ptr::poly_collection<base, sizeof(derived)>;
+
+// counts which overload each element was visited through
+struct visitor {
+  int* typed;
+  int* generic;
+  int* sum;
+  void operator()(derived& d) { ++*typed; *sum += d.get(); }
+  void operator()(base& b) { ++*generic; *sum += b.get(); }
+};
+
+TEST(PolyCollection, Emplace)
+{
+  collection c;
+  ASSERT_TRUE(c.empty());
+  for (int i = 0; i < 30; i++) {
+    switch (i % 3) {
+      case 0: c.emplace<derived>(i); break;
+      case 1: c.emplace<derived2>(); break;
+      default: c.emplace(); break;
+    }
+  }
+  ASSERT_EQ(30u, c.size());
+  ASSERT_EQ(10u, c.count<derived>());
+  ASSERT_EQ(10u, c.count<derived2>());
+  ASSERT_EQ(10u, c.count<base>());
+  c.clear();
+  ASSERT_TRUE(c.empty());
+}
+
+TEST(PolyCollection, ForEach)
+{
+  collection c;
+  int expected = 0;
+  for (int i = 0; i < 30; i++) {
+    switch (i % 3) {
+      case 0: c.emplace<derived>(i); expected += i; break;
+      case 1: c.emplace<derived2>(); expected += 2; break;
+      default: c.emplace(); expected += 1; break;
+    }
+  }
+  int typed = 0, generic = 0, sum = 0;
+  c.for_each<derived>(visitor{&typed, &generic, &sum});
+  ASSERT_EQ(10, typed);
+  ASSERT_EQ(20, generic);
+  ASSERT_EQ(expected, sum);
+
+  typed = generic = sum = 0;
+  c.for_each(visitor{&typed, &generic, &sum});
+  ASSERT_EQ(0, typed);
+  ASSERT_EQ(30, generic);
+  ASSERT_EQ(expected, sum);
+
+  // segments are contiguous per type
+  const collection& cc = c;
+  const derived* prev = nullptr;
+  cc.for_each<derived>([&] (const base& b) {
+    auto d = dynamic_cast<const derived*>(&b);
+    if (d) {
+      if (prev) {
+        ASSERT_EQ(reinterpret_cast<const char*>(prev) + sizeof(derived),
+                  reinterpret_cast<const char*>(d));
+      }
+      prev = d;
+    }
+  });
+}
+
+TEST(PolyCollection, Copy)
+{
+  collection c;
+  c.emplace<derived>(5);
+  c.emplace<derived2>();
+  collection d{c};
+  int typed = 0, generic = 0, sum = 0;
+  d.for_each<derived>(visitor{&typed, &generic, &sum});
+  ASSERT_EQ(1, typed);
+  ASSERT_EQ(1, generic);
+  ASSERT_EQ(7, sum);
+  collection e{std::move(d)};
+  ASSERT_EQ(2u, e.size());
+}
+
+struct counted : base {
+  static int count;
+  counted() noexcept { ++count; }
+  counted(const counted&) noexcept { ++count; }
+  ~counted() { --count; }
+};
+int counted::count = 0;
+
+TEST(PolyCollection, Destruct)
+{
+  counted::count = 0;
+  {
+    static_ptr::poly_collection<base, sizeof(derived)> c;
+    for (int i = 0; i < 100; i++) {
+      c.emplace<counted>();
+    }
+    ASSERT_EQ(100, counted::count);
+  }
+  ASSERT_EQ(0, counted::count);
+}
+
+#ifndef STATIC_PTR_NO_EXCEPTIONS
+// copies throw after a given number of successful copies
+struct throwing_copy {
+  static int count;
+  static int copies_left;
+  throwing_copy() noexcept { ++count; }
+  throwing_copy(const throwing_copy&) {
+    if (copies_left-- == 0) {
+      throw std::runtime_error("copy");
+    }
+    ++count;
+  }
+  throwing_copy(throwing_copy&&) noexcept { ++count; }
+  throwing_copy& operator=(const throwing_copy&) = default;
+  throwing_copy& operator=(throwing_copy&&) = default;
+  virtual ~throwing_copy() { --count; }
+};
+int throwing_copy::count = 0;
+int throwing_copy::copies_left = 0;
+
+TEST(PolyCollection, CopyThrows)
+{
+  throwing_copy::count = 0;
+  static_ptr::poly_collection<throwing_copy> c;
+  for (int i = 0; i < 5; i++) {
+    c.emplace();
+  }
+  throwing_copy::copies_left = 2;
+  ASSERT_THROW(static_ptr::poly_collection<throwing_copy>{c},
+               std::runtime_error);
+  ASSERT_EQ(5, throwing_copy::count);
+}
+#endif
+
+struct text {
+  std::string value;
+  explicit text(std::string value) : value(std::move(value)) {}
+  text(const text&) = default;
+  text(text&&) noexcept = default;
+  virtual ~text() = default;
+};
+
+TEST(PolyCollection, EmplaceOwnElement)
+{
+  // the first segment grows at 8 elements, and the argument refers to an
+  // element that is moved by the growth
+  static_ptr::poly_collection<text> c;
+  c.emplace(std::string(32, 'x'));
+  const text* first = nullptr;
+  c.for_each([&](text& t) { if (!first) first = &t; });
+  for (int i = 1; i < 8; i++) {
+    c.emplace(std::string{"filler"});
+  }
+  c.emplace(*first);
+  ASSERT_EQ(9u, c.size());
+  int copies = 0;
+  c.for_each([&](text& t) { copies += t.value == std::string(32, 'x'); });
+  ASSERT_EQ(2, copies);
+}
@@ -0,0 +1,126 @@
+#include <static_ptr/pooled_ptr.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+template <typename T>
+using in_place_t = static_ptr::in_place_t<T>;
+
+struct base {
+  virtual ~base() = default;
+  virtual int get_value() const { return 0; }
+};
+struct derived : base {
+  int value;
+  explicit derived(int value) : value(value) {}
+  int get_value() const override { return value; }
+};
+#ifndef STATIC_PTR_NO_EXCEPTIONS
+struct throwing : base {
+  throwing() { throw std::runtime_error("fail"); }
+};
+#endif
+
+using base_ptr = static_ptr::pooled_ptr<base, sizeof(derived)>;
+
+TEST(SlotPool, Layout)
+{
+  using pool = static_ptr::slot_pool<24, 16>;
+  ASSERT_EQ(32u, pool::slot_size);
+  ASSERT_EQ(16u, pool::alignment);
+  void* p = pool::allocate();
+  ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(p) % 16);
+  pool::deallocate(p);
+  // the free list is lifo, so the slot is reused
+  ASSERT_EQ(p, pool::allocate());
+  pool::deallocate(p);
+}
+
+TEST(PooledPtr, Factory)
+{
+  auto a = base_ptr::make<derived>(3);
+  ASSERT_TRUE(a);
+  ASSERT_EQ(3, a->get_value());
+  a.emplace<base>();
+  ASSERT_EQ(0, a->get_value());
+  a.reset();
+  ASSERT_FALSE(a);
+  base_ptr b{in_place_t<derived>{}, 4};
+  ASSERT_EQ(4, b->get_value());
+}
+
+TEST(PooledPtr, MoveKeepsAddress)
+{
+  auto a = base_ptr::make<derived>(5);
+  const base* p = a.get();
+  base_ptr b{std::move(a)};
+  ASSERT_FALSE(a);
+  ASSERT_EQ(p, b.get());
+  base_ptr c;
+  c = std::move(b);
+  ASSERT_EQ(p, c.get());
+  ASSERT_EQ(5, c->get_value());
+}
+
+TEST(PooledPtr, ConvertingMove)
+{
+  using derived_ptr = static_ptr::pooled_ptr<derived, sizeof(derived),
+                                             alignof(base)>;
+  auto d = derived_ptr::make(6);
+  base_ptr b{std::move(d)};
+  ASSERT_FALSE(d);
+  ASSERT_EQ(6, b->get_value());
+}
+
+#ifndef STATIC_PTR_NO_EXCEPTIONS
+TEST(PooledPtr, ThrowingConstructor)
+{
+  auto a = base_ptr::make<derived>(7);
+  ASSERT_THROW(a.emplace<throwing>(), std::runtime_error);
+  ASSERT_EQ(7, a->get_value());
+  // the slot taken by the failed construction went back to the pool
+  void* p = base_ptr::pool::allocate();
+  base_ptr::pool::deallocate(p);
+  ASSERT_EQ(p, base_ptr::pool::allocate());
+  base_ptr::pool::deallocate(p);
+}
+#endif
+
+TEST(PooledPtr, Threads)
+{
+  constexpr int count = 10000;
+  constexpr int threads = 4;
+  // each thread allocates objects that another thread frees
+  std::vector<std::vector<base_ptr>> ptrs(threads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&ptrs, t] {
+      for (int i = 0; i < count; i++) {
+        ptrs[t].push_back(base_ptr::make<derived>(i));
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  std::set<const base*> addresses;
+  for (auto& v : ptrs) {
+    for (int i = 0; i < count; i++) {
+      ASSERT_EQ(i, v[i]->get_value());
+      addresses.insert(v[i].get());
+    }
+  }
+  ASSERT_EQ(size_t(count * threads), addresses.size());
+  workers.clear();
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&ptrs, t] {
+      ptrs[(t + 1) % threads].clear();
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+}
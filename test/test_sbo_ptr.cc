@@ -0,0 +1,140 @@
+#include <static_ptr/sbo_ptr.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+template <typename T>
+using in_place_t = static_ptr::in_place_t<T>;
+
+struct base {
+  virtual ~base() = default;
+  virtual std::string get_name() const { return "base"; }
+};
+struct small : base {
+  std::string get_name() const override { return "small"; }
+};
+struct large : base {
+  char payload[256] = "large";
+  std::string get_name() const override { return payload; }
+};
+
+// allocator that counts the live allocations
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+  int* count;
+  explicit counting_allocator(int* count) : count(count) {}
+  template <typename U>
+  counting_allocator(const counting_allocator<U>& o) : count(o.count) {}
+  T* allocate(size_t n) {
+    ++*count;
+    return std::allocator<T>{}.allocate(n);
+  }
+  void deallocate(T* p, size_t n) {
+    --*count;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+  template <typename U>
+  bool operator==(const counting_allocator<U>& o) const { return count == o.count; }
+  template <typename U>
+  bool operator!=(const counting_allocator<U>& o) const { return count != o.count; }
+};
+
+using base_ptr = static_ptr::sbo_ptr<base, sizeof(small)>;
+using counted_ptr = static_ptr::sbo_ptr<base, sizeof(small),
+                                        counting_allocator<base>>;
+
+TEST(SboPtr, FitsInline)
+{
+  ASSERT_TRUE(base_ptr::fits_inline<small>());
+  ASSERT_FALSE(base_ptr::fits_inline<large>());
+  ASSERT_EQ(sizeof(static_ptr::static_ptr<base, sizeof(small)>),
+            sizeof(base_ptr));
+}
+
+TEST(SboPtr, Factory)
+{
+  auto a = base_ptr::make<small>();
+  ASSERT_FALSE(a.spilled());
+  ASSERT_EQ("small", a->get_name());
+  auto b = base_ptr::make<large>();
+  ASSERT_TRUE(b.spilled());
+  ASSERT_EQ("large", b->get_name());
+  b.emplace<small>();
+  ASSERT_FALSE(b.spilled());
+  ASSERT_EQ("small", b->get_name());
+  b.reset();
+  ASSERT_FALSE(b);
+}
+
+TEST(SboPtr, MoveStealsSpilledPointer)
+{
+  int count = 0;
+  {
+    counted_ptr a{std::allocator_arg, counting_allocator<base>{&count},
+                  in_place_t<large>{}};
+    ASSERT_EQ(1, count);
+    const base* p = a.get();
+    counted_ptr b{std::move(a)};
+    ASSERT_FALSE(a);
+    ASSERT_EQ(p, b.get());
+    ASSERT_EQ(1, count);
+    counted_ptr c{counting_allocator<base>{&count}};
+    c = std::move(b);
+    ASSERT_FALSE(b);
+    ASSERT_EQ(p, c.get());
+    ASSERT_EQ(1, count);
+  }
+  ASSERT_EQ(0, count);
+}
+
+TEST(SboPtr, MoveBetweenAllocators)
+{
+  int count1 = 0;
+  int count2 = 0;
+  {
+    counted_ptr a{std::allocator_arg, counting_allocator<base>{&count1},
+                  in_place_t<large>{}};
+    counted_ptr b{counting_allocator<base>{&count2}};
+    b = std::move(a);
+    ASSERT_FALSE(a);
+    ASSERT_EQ("large", b->get_name());
+    ASSERT_EQ(0, count1);
+    ASSERT_EQ(1, count2);
+  }
+  ASSERT_EQ(0, count2);
+}
+
+TEST(SboPtr, MoveInline)
+{
+  int count = 0;
+  counted_ptr a{std::allocator_arg, counting_allocator<base>{&count},
+                in_place_t<small>{}};
+  ASSERT_EQ(0, count);
+  counted_ptr b{std::move(a)};
+  ASSERT_FALSE(a);
+  ASSERT_FALSE(b.spilled());
+  ASSERT_EQ("small", b->get_name());
+  ASSERT_EQ(0, count);
+}
+
+TEST(SboPtr, Copyable)
+{
+  int count = 0;
+  {
+    counted_ptr a{std::allocator_arg, counting_allocator<base>{&count},
+                  in_place_t<large>{}};
+    counted_ptr b{a};
+    ASSERT_EQ(2, count);
+    ASSERT_NE(a.get(), b.get());
+    ASSERT_EQ("large", b->get_name());
+    counted_ptr c{std::allocator_arg, counting_allocator<base>{&count},
+                  in_place_t<small>{}};
+    b = c;
+    ASSERT_EQ(1, count);
+    ASSERT_EQ("small", b->get_name());
+    c = a;
+    ASSERT_EQ(2, count);
+    ASSERT_EQ("large", c->get_name());
+  }
+  ASSERT_EQ(0, count);
+}
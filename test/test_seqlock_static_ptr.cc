@@ -0,0 +1,138 @@
+#include <static_ptr/seqlock_static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// payloads whose fields always hold the same value, so torn reads show up as
+// mismatched fields
+struct route {
+  std::uint64_t version = 0;
+  std::uint64_t check = 0;
+  route() = default;
+  explicit route(std::uint64_t v) : version(v), check(v) {}
+};
+struct weighted_route : route {
+  std::uint64_t weights[6] = {};
+  weighted_route() = default;
+  explicit weighted_route(std::uint64_t v) : route(v) {
+    for (auto& w : weights) w = v;
+  }
+};
+
+using route_ptr = static_ptr::seqlock_static_ptr<route, sizeof(weighted_route)>;
+
+bool consistent(const route_ptr::static_ptr_type& p)
+{
+  if (!p) {
+    return true;
+  }
+  if (p->version != p->check) {
+    return false;
+  }
+  if (p->version % 2) {
+    // odd versions are weighted_route
+    auto w = static_cast<const weighted_route*>(p.get());
+    for (auto v : w->weights) {
+      if (v != p->version) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST(SeqlockStaticPtr, Empty)
+{
+  route_ptr slot;
+  ASSERT_FALSE(slot.load());
+}
+
+TEST(SeqlockStaticPtr, EmplaceLoad)
+{
+  route_ptr slot;
+  slot.emplace<weighted_route>(3);
+  auto p = slot.load();
+  ASSERT_TRUE(p);
+  ASSERT_EQ(3u, p->version);
+  ASSERT_EQ(3u, static_cast<weighted_route&>(*p).weights[5]);
+
+  slot.emplace<route>(4);
+  slot.load(p);
+  ASSERT_EQ(4u, p->version);
+
+  slot.reset();
+  slot.load(p);
+  ASSERT_FALSE(p);
+}
+
+TEST(SeqlockStaticPtr, Store)
+{
+  route_ptr slot;
+  auto p = route_ptr::static_ptr_type::make<weighted_route>(5);
+  slot.store(p);
+  auto q = slot.load();
+  ASSERT_EQ(5u, q->version);
+  ASSERT_TRUE(consistent(q));
+}
+
+// a payload aligned to bytes, less than the words it's copied in
+struct bytes {
+  char c[3];
+};
+
+TEST(SeqlockStaticPtr, ByteAligned)
+{
+  using bytes_ptr = static_ptr::seqlock_static_ptr<bytes>;
+  static_assert(alignof(bytes) == 1, "");
+  bytes_ptr slot;
+  slot.emplace<bytes>(bytes{{'a', 'b', 'c'}});
+  auto p = slot.load();
+  ASSERT_TRUE(p);
+  ASSERT_EQ('a', p->c[0]);
+  ASSERT_EQ('c', p->c[2]);
+}
+
+TEST(SeqlockStaticPtr, Stress)
+{
+  constexpr std::uint64_t writes = 100000;
+  constexpr int readers = 4;
+  route_ptr slot;
+  slot.emplace<route>(0);
+
+  std::atomic<bool> done{false};
+  std::atomic<int> torn{0};
+  std::atomic<int> regressed{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < readers; i++) {
+    threads.emplace_back([&] {
+      route_ptr::static_ptr_type p;
+      std::uint64_t last = 0;
+      while (!done.load(std::memory_order_acquire)) {
+        slot.load(p);
+        if (!consistent(p)) {
+          ++torn;
+        }
+        if (p->version < last) {
+          ++regressed;
+        }
+        last = p->version;
+      }
+    });
+  }
+  for (std::uint64_t v = 1; v <= writes; v++) {
+    if (v % 2) {
+      slot.emplace<weighted_route>(v);
+    } else {
+      slot.emplace<route>(v);
+    }
+  }
+  done.store(true, std::memory_order_release);
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(0, torn.load());
+  ASSERT_EQ(0, regressed.load());
+  ASSERT_EQ(writes, slot.load()->version);
+}
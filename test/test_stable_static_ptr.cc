@@ -0,0 +1,184 @@
+#include <static_ptr/stable_static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+struct shape {
+  int kind;
+};
+struct circle : shape {
+  float radius;
+  explicit circle(float radius) : shape{1}, radius(radius) {}
+};
+struct rect : shape {
+  float width, height;
+  rect(float width, float height) : shape{2}, width(width), height(height) {}
+};
+// never stored, only registered to test id conflicts
+struct other_circle : shape {};
+// never registered
+struct triangle : shape {
+  float a, b, c;
+};
+
+namespace static_ptr {
+template <> struct stable_type_id<circle>
+    : std::integral_constant<std::uint32_t, 1> {};
+template <> struct stable_type_id<rect>
+    : std::integral_constant<std::uint32_t, 2> {};
+template <> struct stable_type_id<other_circle>
+    : std::integral_constant<std::uint32_t, 1> {};
+template <> struct stable_type_id<triangle>
+    : std::integral_constant<std::uint32_t, 3> {};
+} // namespace static_ptr
+
+using ptr = static_ptr::stable_static_ptr<shape, 16>;
+using registry = static_ptr::stable_type_registry;
+
+static_assert(std::is_trivially_copyable<ptr>::value,
+              "stable_static_ptr must be trivially copyable");
+static_assert(std::is_standard_layout<ptr>::value,
+              "stable_static_ptr must be standard layout");
+
+TEST(StableStaticPtr, Empty)
+{
+  ptr p;
+  ASSERT_FALSE(p);
+  ASSERT_EQ(0u, p.id());
+  ASSERT_EQ(nullptr, p.get());
+  ASSERT_EQ(nullptr, p.type());
+  ASSERT_TRUE(p.valid());
+  ASSERT_FALSE(p.load());
+}
+
+TEST(StableStaticPtr, Emplace)
+{
+  ptr p{static_ptr::in_place_t<circle>{}, 2.0f};
+  ASSERT_TRUE(p);
+  ASSERT_EQ(1u, p.id());
+  ASSERT_TRUE(p.holds<circle>());
+  ASSERT_FALSE(p.holds<rect>());
+  ASSERT_EQ(1, p->kind);
+  ASSERT_EQ(2.0f, p.get_if<circle>()->radius);
+  ASSERT_EQ(nullptr, p.get_if<rect>());
+  // emplace registered the type in this process
+  ASSERT_EQ((static_ptr::_::type_erasure_ops::get_operate<circle>()), p.type());
+
+  auto& r = p.emplace<rect>(3.0f, 4.0f);
+  ASSERT_EQ(2u, p.id());
+  ASSERT_EQ(&r, p.get_if<rect>());
+  ASSERT_EQ(2, p->kind);
+  p.reset();
+  ASSERT_FALSE(p);
+}
+
+TEST(StableStaticPtr, Load)
+{
+  ptr p{static_ptr::in_place_t<rect>{}, 3.0f, 4.0f};
+  static_ptr::static_ptr<shape, 16> s = p.load();
+  ASSERT_TRUE(s);
+  ASSERT_EQ(2, s->kind);
+  ASSERT_EQ(4.0f, static_cast<rect*>(s.get())->height);
+  static_ptr::static_ptr<shape, 16> copy = s;
+  ASSERT_EQ(3.0f, static_cast<rect*>(copy.get())->width);
+}
+
+// an array written out as raw bytes can be used in place when read back,
+// as it would be from a memory-mapped file
+TEST(StableStaticPtr, RoundTripBytes)
+{
+  std::vector<ptr> written(4);
+  written[0].emplace<circle>(1.0f);
+  written[1].emplace<rect>(2.0f, 3.0f);
+  written[3].emplace<circle>(4.0f);
+
+  std::FILE* f = std::tmpfile();
+  ASSERT_NE(nullptr, f);
+  ASSERT_EQ(written.size(),
+            std::fwrite(written.data(), sizeof(ptr), written.size(), f));
+  std::rewind(f);
+  alignas(ptr) unsigned char mapped[4 * sizeof(ptr)];
+  ASSERT_EQ(4u, std::fread(mapped, sizeof(ptr), 4, f));
+  std::fclose(f);
+
+  auto read = reinterpret_cast<const ptr*>(mapped);
+  ASSERT_TRUE(read[0].holds<circle>());
+  ASSERT_EQ(1.0f, read[0].get_if<circle>()->radius);
+  ASSERT_TRUE(read[1].holds<rect>());
+  ASSERT_EQ(3.0f, read[1].get_if<rect>()->height);
+  ASSERT_FALSE(read[2]);
+  ASSERT_EQ(4.0f, read[3].get_if<circle>()->radius);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(read[i].valid());
+  }
+}
+
+// no byte of an object constructed in place keeps the previous contents of
+// the memory, including the padding between the id and the buffer
+TEST(StableStaticPtr, ZeroedPadding)
+{
+  using aligned_ptr = static_ptr::stable_static_ptr<shape, 12, 8>;
+  static_assert(sizeof(aligned_ptr) == 24, "");
+  alignas(aligned_ptr) unsigned char bytes[sizeof(aligned_ptr)];
+
+  std::memset(bytes, 0xaa, sizeof(bytes));
+  auto p = new (bytes) aligned_ptr;
+  for (unsigned char b : bytes) {
+    ASSERT_EQ(0, b);
+  }
+  p->~aligned_ptr();
+
+  std::memset(bytes, 0xaa, sizeof(bytes));
+  p = new (bytes) aligned_ptr{static_ptr::in_place_t<circle>{}, 1.0f};
+  for (unsigned char b : bytes) {
+    ASSERT_NE(0xaa, b);
+  }
+  std::memset(bytes + sizeof(aligned_ptr::id_type), 0xaa,
+              sizeof(bytes) - sizeof(aligned_ptr::id_type));
+  p->emplace<circle>(2.0f);
+  for (unsigned char b : bytes) {
+    ASSERT_NE(0xaa, b);
+  }
+  ASSERT_EQ(2.0f, p->get_if<circle>()->radius);
+}
+
+TEST(StableStaticPtr, Unregistered)
+{
+  // a triangle written by another process that this one never registered
+  ptr p;
+  auto bytes = reinterpret_cast<unsigned char*>(&p);
+  const std::uint32_t id = 3;
+  std::memcpy(bytes, &id, sizeof(id));
+  ASSERT_EQ(3u, p.id());
+  ASSERT_TRUE(p.holds<triangle>());
+  ASSERT_EQ(nullptr, p.type());
+  ASSERT_FALSE(p.valid());
+  ASSERT_FALSE(p.load());
+
+  registry::add<triangle>();
+  ASSERT_TRUE(p.valid());
+  ASSERT_TRUE(p.load());
+
+  // ids past the table are never valid
+  const std::uint32_t bad = registry::max_id + 1;
+  std::memcpy(bytes, &bad, sizeof(bad));
+  ASSERT_EQ(nullptr, p.type());
+  ASSERT_FALSE(p.valid());
+}
+
+TEST(StableStaticPtr, Conflict)
+{
+  registry::add<circle, rect>();
+  // registering the same type again is fine
+  registry::add<circle>();
+#ifdef STATIC_PTR_NO_EXCEPTIONS
+  ASSERT_DEATH(registry::add<other_circle>(),
+               "stable_type_id registered for two types");
+#else
+  ASSERT_THROW(registry::add<other_circle>(), std::logic_error);
+#endif
+  ASSERT_EQ((static_ptr::_::type_erasure_ops::get_operate<circle>()),
+            registry::find(1));
+}
@@ -0,0 +1,154 @@
+#include <static_ptr/static_any.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using any = static_ptr::static_any<32>;
+using static_ptr::any_cast;
+
+TEST(StaticAny, Empty)
+{
+  any a;
+  ASSERT_FALSE(a.has_value());
+  ASSERT_EQ(nullptr, a.type());
+  ASSERT_EQ(nullptr, any_cast<int>(&a));
+#ifdef STATIC_PTR_NO_EXCEPTIONS
+  ASSERT_DEATH(any_cast<int>(a), "bad static_any cast");
+#else
+  ASSERT_THROW(any_cast<int>(a), static_ptr::bad_static_any_cast);
+#endif
+}
+
+TEST(StaticAny, Value)
+{
+  any a{42};
+  ASSERT_TRUE(a.has_value());
+  ASSERT_TRUE(a.holds<int>());
+  ASSERT_FALSE(a.holds<long>());
+  ASSERT_EQ(42, any_cast<int>(a));
+  ASSERT_EQ(nullptr, any_cast<long>(&a));
+#ifdef STATIC_PTR_NO_EXCEPTIONS
+  ASSERT_DEATH(any_cast<long>(a), "bad static_any cast");
+#else
+  ASSERT_THROW(any_cast<long>(a), static_ptr::bad_static_any_cast);
+#endif
+
+  any_cast<int&>(a) = 7;
+  ASSERT_EQ(7, *any_cast<int>(&a));
+
+  a = std::string{"text"};
+  ASSERT_EQ("text", any_cast<const std::string&>(a));
+  a.reset();
+  ASSERT_FALSE(a.has_value());
+}
+
+TEST(StaticAny, Emplace)
+{
+  any a;
+  auto& v = a.emplace<std::vector<int>>(3, 1);
+  ASSERT_EQ(3u, v.size());
+  ASSERT_EQ(&v, any_cast<std::vector<int>>(&a));
+  any b{static_ptr::in_place_t<std::string>{}, 3, 'x'};
+  ASSERT_EQ("xxx", any_cast<std::string>(b));
+}
+
+TEST(StaticAny, Copy)
+{
+  any a{std::string{"copied"}};
+  any b{a};
+  ASSERT_EQ("copied", any_cast<std::string>(a));
+  ASSERT_EQ("copied", any_cast<std::string>(b));
+  ASSERT_NE(any_cast<std::string>(&a), any_cast<std::string>(&b));
+  any c{1.5};
+  c = a;
+  ASSERT_EQ("copied", any_cast<std::string>(c));
+  c = any{2};
+  ASSERT_EQ(2, any_cast<int>(c));
+}
+
+TEST(StaticAny, Move)
+{
+  any a{std::string{"moved"}};
+  any b{std::move(a)};
+  ASSERT_FALSE(a.has_value());
+  ASSERT_EQ("moved", any_cast<std::string>(b));
+  any c{3};
+  c = std::move(b);
+  ASSERT_FALSE(b.has_value());
+  ASSERT_EQ("moved", any_cast<std::string>(std::move(c)));
+}
+
+// types without copy construction or assignment use the static_ptr fallbacks
+struct assign_only {
+  int value = 0;
+  assign_only() = default;
+  explicit assign_only(int value) : value(value) {}
+  assign_only(const assign_only&) = delete;
+  assign_only& operator=(const assign_only&) = default;
+  assign_only(assign_only&&) = delete;
+  assign_only& operator=(assign_only&&) = default;
+};
+struct construct_only {
+  const int value;
+  explicit construct_only(int value) : value(value) {}
+  construct_only(const construct_only&) = default;
+  construct_only(construct_only&&) = default;
+};
+
+TEST(StaticAny, Fallbacks)
+{
+  any a{static_ptr::in_place_t<assign_only>{}, 4};
+  any b{a};
+  ASSERT_EQ(4, any_cast<const assign_only&>(b).value);
+  any c{std::move(a)};
+  ASSERT_EQ(4, any_cast<const assign_only&>(c).value);
+
+  any d{construct_only{5}};
+  any e{construct_only{6}};
+  e = d;
+  ASSERT_EQ(5, any_cast<const construct_only&>(e).value);
+  e = any{construct_only{7}};
+  ASSERT_EQ(7, any_cast<const construct_only&>(e).value);
+}
+
+// copy constructible, but the reference member deletes assignment
+struct not_assignable {
+  int& ref;
+  std::string text;
+};
+
+TEST(StaticAny, NotAssignable)
+{
+  using any = static_ptr::static_any<sizeof(not_assignable)>;
+  int i = 1, j = 2;
+  any a{not_assignable{i, "a"}};
+  any b{not_assignable{j, "b"}};
+  a = b;
+  ASSERT_EQ(&j, &any_cast<const not_assignable&>(a).ref);
+  ASSERT_EQ("b", any_cast<const not_assignable&>(a).text);
+  ASSERT_EQ("b", any_cast<const not_assignable&>(b).text);
+  a = any{not_assignable{i, "c"}};
+  ASSERT_EQ(&i, &any_cast<const not_assignable&>(a).ref);
+  ASSERT_EQ("c", any_cast<const not_assignable&>(a).text);
+  a = std::move(b);
+  ASSERT_FALSE(b.has_value());
+  ASSERT_EQ("b", any_cast<const not_assignable&>(a).text);
+  static_assert(std::is_nothrow_move_assignable<any>::value, "");
+}
+
+#ifndef STATIC_PTR_NO_EXCEPTIONS
+struct throwing_copy {
+  throwing_copy() = default;
+  throwing_copy(const throwing_copy&) { throw std::runtime_error("copy"); }
+  throwing_copy(throwing_copy&&) noexcept {}
+};
+
+TEST(StaticAny, CopyAssignKeepsValueOnThrow)
+{
+  any a{std::string{"kept"}};
+  any b{static_ptr::in_place_t<throwing_copy>{}};
+  ASSERT_THROW(a = b, std::runtime_error);
+  ASSERT_EQ("kept", any_cast<const std::string&>(a));
+}
+#endif
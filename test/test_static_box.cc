@@ -0,0 +1,133 @@
+#include <static_ptr/static_box.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+template <typename T>
+using in_place_t = static_ptr::in_place_t<T>;
+
+struct base {
+  virtual ~base() = default;
+  virtual const char* get_name() const { return "base"; }
+};
+struct derived : base {
+  int value = 0;
+  derived() = default;
+  explicit derived(int value) : value(value) {}
+  const char* get_name() const override { return "derived"; }
+};
+
+using base_box = static_ptr::static_box<base, sizeof(derived)>;
+
+TEST(StaticBox, Layout)
+{
+  ASSERT_EQ(sizeof(static_ptr::static_ptr<base, sizeof(derived)>),
+            sizeof(base_box));
+  ASSERT_FALSE(std::is_default_constructible<base_box>::value);
+  ASSERT_TRUE(std::is_nothrow_move_constructible<base_box>::value);
+  ASSERT_TRUE(std::is_nothrow_move_assignable<base_box>::value);
+}
+
+TEST(StaticBox, Factory)
+{
+  auto a = base_box::make<derived>(4);
+  ASSERT_EQ("derived", a->get_name());
+  ASSERT_EQ(base_box::make<derived>().type(), a.type());
+  a.emplace<base>();
+  ASSERT_EQ("base", a->get_name());
+  base_box b{in_place_t<derived>{}, 2};
+  ASSERT_EQ(2, static_cast<derived&>(*b).value);
+}
+
+TEST(StaticBox, MoveConstructLeavesBase)
+{
+  base_box a{in_place_t<derived>{}, 3};
+  base_box b{std::move(a)};
+  ASSERT_EQ("derived", b->get_name());
+  ASSERT_EQ(3, static_cast<derived&>(*b).value);
+  // the source holds a default constructed base instead of nothing
+  ASSERT_EQ("base", a->get_name());
+}
+
+TEST(StaticBox, MoveAssignSwaps)
+{
+  auto a = base_box::make<derived>(5);
+  auto b = base_box::make<base>();
+  b = std::move(a);
+  ASSERT_EQ("derived", b->get_name());
+  ASSERT_EQ("base", a->get_name());
+  swap(a, b);
+  ASSERT_EQ("derived", a->get_name());
+  ASSERT_EQ(5, static_cast<derived&>(*a).value);
+}
+
+TEST(StaticBox, Copy)
+{
+  auto a = base_box::make<derived>(6);
+  base_box b{a};
+  ASSERT_EQ("derived", b->get_name());
+  ASSERT_EQ(6, static_cast<derived&>(*b).value);
+  auto c = base_box::make<base>();
+  c = a;
+  ASSERT_EQ(6, static_cast<derived&>(*c).value);
+  static_cast<derived&>(*a).value = 7;
+  c = a;
+  ASSERT_EQ(7, static_cast<derived&>(*c).value);
+}
+
+// types that can throw on construction
+struct throwing_base {
+  explicit throwing_base(int) {}
+  virtual ~throwing_base() = default;
+  virtual int id() const { return 0; }
+};
+#ifndef STATIC_PTR_NO_EXCEPTIONS
+struct throwing : throwing_base {
+  explicit throwing(bool fail) : throwing_base(0) {
+    if (fail) throw std::runtime_error("fail");
+  }
+  int id() const override { return 1; }
+};
+
+TEST(StaticBox, EmplaceKeepsValueOnThrow)
+{
+  static_ptr::static_box<throwing_base> a{in_place_t<throwing_base>{}, 0};
+  a.emplace<throwing>(false);
+  ASSERT_EQ(1, a->id());
+  ASSERT_THROW(a.emplace<throwing>(true), std::runtime_error);
+  ASSERT_EQ(1, a->id());
+}
+#endif
+
+TEST(StaticBox, NoDefaultConstructor)
+{
+  using throwing_box = static_ptr::static_box<throwing_base>;
+  // move construction falls back to copy, which leaves the source engaged
+  throwing_box a{in_place_t<throwing_base>{}, 0};
+  throwing_box b{std::move(a)};
+  ASSERT_EQ(0, a->id());
+  ASSERT_EQ(0, b->id());
+}
+
+// an abstract base is only swappable
+struct abstract {
+  virtual ~abstract() = default;
+  virtual int id() const = 0;
+};
+struct concrete1 : abstract {
+  int id() const override { return 1; }
+};
+struct concrete2 : abstract {
+  int id() const override { return 2; }
+};
+
+TEST(StaticBox, AbstractBase)
+{
+  using abstract_box = static_ptr::static_box<abstract, sizeof(concrete1)>;
+  ASSERT_FALSE(std::is_move_constructible<abstract_box>::value);
+  ASSERT_FALSE(std::is_copy_constructible<abstract_box>::value);
+  abstract_box a{in_place_t<concrete1>{}};
+  abstract_box b{in_place_t<concrete2>{}};
+  a = std::move(b);
+  ASSERT_EQ(2, a->id());
+  ASSERT_EQ(1, b->id());
+}
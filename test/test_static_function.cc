@@ -0,0 +1,148 @@
+#include <static_ptr/static_function.hpp>
+#include <gtest/gtest.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+using int_function = static_ptr::static_function<int(int), 32>;
+using string_function = static_ptr::static_function<std::string(), 64>;
+
+int twice(int i) { return 2 * i; }
+
+TEST(StaticFunction, Empty)
+{
+  int_function f;
+  ASSERT_FALSE(f);
+#ifdef STATIC_PTR_NO_EXCEPTIONS
+  ASSERT_DEATH(f(1), "bad_function_call");
+#else
+  ASSERT_THROW(f(1), std::bad_function_call);
+#endif
+  int_function g{nullptr};
+  ASSERT_FALSE(g);
+}
+
+TEST(StaticFunction, Callables)
+{
+  int_function f{twice};
+  ASSERT_TRUE(f);
+  ASSERT_EQ(4, f(2));
+  int offset = 3;
+  f = [offset] (int i) { return i + offset; };
+  ASSERT_EQ(5, f(2));
+  f = std::negate<int>{};
+  ASSERT_EQ(-2, f(2));
+  f = nullptr;
+  ASSERT_FALSE(f);
+}
+
+TEST(StaticFunction, VoidResult)
+{
+  int calls = 0;
+  // the result of the callable is discarded
+  static_ptr::static_function<void(int), 16> f{[&calls] (int i) {
+    calls += i;
+    return calls;
+  }};
+  f(2);
+  f(3);
+  ASSERT_EQ(5, calls);
+}
+
+TEST(StaticFunction, Copy)
+{
+  std::string name = "captured";
+  string_function f{[name] { return name; }};
+  string_function g{f};
+  ASSERT_EQ("captured", f());
+  ASSERT_EQ("captured", g());
+  string_function h;
+  h = g;
+  ASSERT_EQ("captured", h());
+}
+
+TEST(StaticFunction, Move)
+{
+  std::string name = "moved";
+  string_function f{[name] { return name; }};
+  string_function g{std::move(f)};
+  ASSERT_FALSE(f);
+  ASSERT_EQ("moved", g());
+  f = std::move(g);
+  ASSERT_FALSE(g);
+  ASSERT_EQ("moved", f());
+}
+
+// callable that counts its live instances
+struct counted {
+  static int count;
+  counted() { ++count; }
+  counted(const counted&) noexcept { ++count; }
+  ~counted() { --count; }
+  int operator()(int i) const { return i; }
+};
+int counted::count = 0;
+
+TEST(StaticFunction, Destroy)
+{
+  {
+    int_function f{counted{}};
+    ASSERT_EQ(1, counted::count);
+    int_function g{f};
+    ASSERT_EQ(2, counted::count);
+    g = twice;
+    ASSERT_EQ(1, counted::count);
+  }
+  ASSERT_EQ(0, counted::count);
+}
+
+TEST(StaticFunction, MoveOnly)
+{
+  using function = static_ptr::move_only_static_function<int(), 16>;
+  ASSERT_FALSE(std::is_copy_constructible<function>::value);
+  ASSERT_TRUE(std::is_nothrow_move_constructible<function>::value);
+  std::unique_ptr<int> p{new int{7}};
+  // c++11 lambdas can't capture by move, so wrap the unique_ptr in a struct
+  struct owner {
+    std::unique_ptr<int> p;
+    int operator()() const { return *p; }
+  };
+  function f{owner{std::move(p)}};
+  ASSERT_EQ(7, f());
+  function g{std::move(f)};
+  ASSERT_EQ(7, g());
+  ASSERT_FALSE(f);
+}
+
+TEST(StaticFunction, Noexcept)
+{
+  using function = static_ptr::static_function<int(int), 16, true>;
+  function f{[] (int i) noexcept { return i + 1; }};
+  ASSERT_TRUE(noexcept(f(1)));
+  ASSERT_EQ(2, f(1));
+  ASSERT_FALSE(noexcept(std::declval<int_function&>()(1)));
+}
+
+TEST(StaticFunction, Fits)
+{
+  ASSERT_TRUE(int_function::fits<int(*)(int)>());
+  struct big { char data[64]; int operator()(int) const { return 0; } };
+  ASSERT_FALSE(int_function::fits<big>());
+}
+
+// overloads on the signature pick the one the callable can be invoked as
+static int call(const int_function& f) { return f(1); }
+static int call(const string_function& f) { return static_cast<int>(f().size()); }
+
+TEST(StaticFunction, Constraints)
+{
+  ASSERT_FALSE((std::is_constructible<int_function, std::string>::value));
+  ASSERT_FALSE((std::is_constructible<int_function, int(*)()>::value));
+  ASSERT_FALSE((std::is_constructible<int_function,
+                                      std::string(*)(int)>::value));
+  ASSERT_TRUE((std::is_constructible<int_function, long(*)(long)>::value));
+  ASSERT_TRUE((std::is_constructible<static_ptr::static_function<void(int), 16>,
+                                     std::string(*)(int)>::value));
+  ASSERT_EQ(2, call([] (int i) { return 2 * i; }));
+  ASSERT_EQ(3, call([] { return std::string{"abc"}; }));
+}
@@ -0,0 +1,184 @@
+#include <static_ptr/static_ptr_algorithm.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+// counts live objects to catch leaks and double destruction
+static int live = 0;
+
+struct base {
+  int value;
+  explicit base(int value) noexcept : value(value) { live++; }
+  base(const base& o) noexcept : value(o.value) { live++; }
+  base& operator=(const base& o) noexcept { value = o.value; return *this; }
+  virtual ~base() { live--; }
+  virtual int get() const { return value; }
+};
+struct derived : base {
+  int extra;
+  derived(int value, int extra) noexcept : base(value), extra(extra) {}
+  int get() const override { return value + extra; }
+};
+
+using ptr = static_ptr::static_ptr<base, sizeof(derived)>;
+
+// uninitialized storage for n handles
+template <typename P, size_t N>
+struct storage {
+  alignas(P) unsigned char bytes[N * sizeof(P)];
+  P* get() { return reinterpret_cast<P*>(bytes); }
+  P& operator[](size_t i) { return get()[i]; }
+};
+
+// a mix of runs of each type, and empty handles
+template <typename P, size_t N>
+static void fill(storage<P, N>& s)
+{
+  for (size_t i = 0; i < N; i++) {
+    const int v = static_cast<int>(i);
+    if (i % 7 == 6) {
+      new (&s[i]) P;
+    } else if (i % 7 < 3) {
+      new (&s[i]) P{static_ptr::in_place_t<base>{}, v};
+    } else {
+      new (&s[i]) P{static_ptr::in_place_t<derived>{}, v, 100};
+    }
+  }
+}
+
+template <typename P, size_t N>
+static void check(storage<P, N>& s)
+{
+  for (size_t i = 0; i < N; i++) {
+    const int v = static_cast<int>(i);
+    if (i % 7 == 6) {
+      ASSERT_FALSE(s[i]);
+    } else if (i % 7 < 3) {
+      ASSERT_EQ(v, s[i]->get());
+    } else {
+      ASSERT_EQ(v + 100, s[i]->get());
+    }
+  }
+}
+
+TEST(StaticPtrAlgorithm, RelocateDestroy)
+{
+  live = 0;
+  storage<ptr, 50> a, b;
+  fill(a);
+  ASSERT_EQ(43, live);
+  auto end = static_ptr::uninitialized_relocate_n(a.get(), 50, b.get());
+  ASSERT_EQ(b.get() + 50, end);
+  ASSERT_EQ(43, live);
+  check(b);
+  ASSERT_EQ(b.get() + 50, static_ptr::destroy_n(b.get(), 50));
+  ASSERT_EQ(0, live);
+}
+
+TEST(StaticPtrAlgorithm, Copy)
+{
+  live = 0;
+  storage<ptr, 50> a, b;
+  fill(a);
+  static_ptr::uninitialized_copy_n(a.get(), 50, b.get());
+  ASSERT_EQ(86, live);
+  check(a);
+  check(b);
+  static_ptr::destroy_n(a.get(), 50);
+  static_ptr::destroy_n(b.get(), 50);
+  ASSERT_EQ(0, live);
+}
+
+TEST(StaticPtrAlgorithm, Empty)
+{
+  storage<ptr, 1> a, b;
+  static_ptr::uninitialized_relocate_n(a.get(), 0, b.get());
+  static_ptr::uninitialized_copy_n(a.get(), 0, b.get());
+  static_ptr::destroy_n(a.get(), 0);
+}
+
+struct trivial {
+  int value;
+};
+
+TEST(StaticPtrAlgorithm, Trivial)
+{
+  using trivial_ptr = static_ptr::static_ptr<trivial>;
+  storage<trivial_ptr, 10> a, b, c;
+  for (int i = 0; i < 10; i++) {
+    new (&a[i]) trivial_ptr{static_ptr::in_place_t<trivial>{}, trivial{i}};
+  }
+  static_ptr::uninitialized_relocate_n(a.get(), 10, b.get());
+  static_ptr::uninitialized_copy_n(b.get(), 10, c.get());
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(i, b[i]->value);
+    ASSERT_EQ(i, c[i]->value);
+  }
+  static_ptr::destroy_n(b.get(), 10);
+  static_ptr::destroy_n(c.get(), 10);
+}
+
+TEST(StaticPtrAlgorithm, Strings)
+{
+  using string_ptr = static_ptr::static_ptr<std::string>;
+  const std::string text(100, 'x');
+  storage<string_ptr, 10> a, b, c;
+  for (int i = 0; i < 10; i++) {
+    new (&a[i]) string_ptr{static_ptr::in_place_t<std::string>{},
+                           text + std::to_string(i)};
+  }
+  static_ptr::uninitialized_relocate_n(a.get(), 10, b.get());
+  static_ptr::uninitialized_copy_n(b.get(), 10, c.get());
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(text + std::to_string(i), *b[i]);
+    ASSERT_EQ(text + std::to_string(i), *c[i]);
+  }
+  static_ptr::destroy_n(b.get(), 10);
+  static_ptr::destroy_n(c.get(), 10);
+}
+
+#ifndef STATIC_PTR_NO_EXCEPTIONS
+// copies throw after a given number of successful copies
+static int copies_left = 0;
+
+struct throwing {
+  int value;
+  explicit throwing(int value) noexcept : value(value) { live++; }
+  throwing(const throwing& o) : value(o.value) {
+    if (copies_left-- == 0) {
+      throw std::runtime_error("copy");
+    }
+    live++;
+  }
+  throwing& operator=(const throwing&) = default;
+  virtual ~throwing() { live--; }
+};
+struct throwing_derived : throwing {
+  using throwing::throwing;
+};
+
+TEST(StaticPtrAlgorithm, CopyThrows)
+{
+  using throwing_ptr = static_ptr::static_ptr<throwing>;
+  static_assert(!noexcept(static_ptr::uninitialized_copy_n(
+      std::declval<const throwing_ptr*>(), 0,
+      std::declval<throwing_ptr*>())), "");
+  live = 0;
+  storage<throwing_ptr, 10> a, b;
+  for (int i = 0; i < 10; i++) {
+    if (i < 3) {
+      new (&a[i]) throwing_ptr{static_ptr::in_place_t<throwing>{}, i};
+    } else {
+      new (&a[i]) throwing_ptr{static_ptr::in_place_t<throwing_derived>{}, i};
+    }
+  }
+  // the run of throwing is copied, then the third copy in the run of
+  // throwing_derived fails
+  copies_left = 5;
+  ASSERT_THROW(static_ptr::uninitialized_copy_n(a.get(), 10, b.get()),
+               std::runtime_error);
+  ASSERT_EQ(10, live);
+  static_ptr::destroy_n(a.get(), 10);
+  ASSERT_EQ(0, live);
+}
+#endif
@@ -0,0 +1,74 @@
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+
+struct base {
+  virtual ~base() = default;
+  virtual const char* get_name() const { return "base"; }
+};
+
+struct small : base {
+  const char* get_name() const override { return "small"; }
+};
+
+struct large : base {
+  std::int64_t payload[3] = {};
+  const char* get_name() const override { return "large"; }
+};
+
+struct alignas(32) aligned : base {
+  const char* get_name() const override { return "aligned"; }
+};
+
+using base_ptr = static_ptr::static_ptr_for<base, small, large>;
+
+static_assert(base_ptr::size == sizeof(large), "size is the largest candidate");
+static_assert(base_ptr::slack<large>() == 0, "largest candidate fills buffer");
+static_assert(base_ptr::slack<small>() == sizeof(large) - sizeof(small),
+              "smaller candidates leave slack");
+static_assert(base_ptr::slack_bytes[0] == base_ptr::slack<small>(),
+              "slack_bytes follows candidate order");
+static_assert(base_ptr::max_slack == base_ptr::slack<small>(),
+              "max_slack is the slack of the smallest candidate");
+static_assert(base_ptr::is_candidate<small>(), "");
+static_assert(!base_ptr::is_candidate<aligned>(), "");
+
+TEST(StaticPtrFor, Layout)
+{
+  ASSERT_EQ(sizeof(static_ptr::static_ptr<base, sizeof(large)>),
+            sizeof(base_ptr));
+  using aligned_ptr = static_ptr::static_ptr_for<base, small, aligned>;
+  ASSERT_EQ(sizeof(aligned), aligned_ptr::size);
+  ASSERT_EQ(32u, aligned_ptr::alignment);
+  ASSERT_EQ(32u, alignof(aligned_ptr));
+}
+
+TEST(StaticPtrFor, Factory)
+{
+  auto a = base_ptr::make<small>();
+  ASSERT_EQ("small", a->get_name());
+  a.emplace<large>();
+  ASSERT_EQ("large", a->get_name());
+  base_ptr b{static_ptr::in_place_t<small>{}};
+  ASSERT_EQ("small", b->get_name());
+}
+
+TEST(StaticPtrFor, MoveCopy)
+{
+  auto a = base_ptr::make<large>();
+  base_ptr b{a};
+  ASSERT_EQ("large", b->get_name());
+  base_ptr c{std::move(a)};
+  ASSERT_EQ("large", c->get_name());
+  c = base_ptr::make<small>();
+  ASSERT_EQ("small", c->get_name());
+}
+
+TEST(StaticPtrFor, ConvertToStaticPtr)
+{
+  auto a = base_ptr::make<large>();
+  base_ptr::static_ptr_type b{a};
+  ASSERT_EQ("large", b->get_name());
+  static_ptr::static_ptr<base, 2 * sizeof(large)> c{std::move(a)};
+  ASSERT_EQ("large", c->get_name());
+}
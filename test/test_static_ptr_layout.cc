@@ -0,0 +1,123 @@
+#define STATIC_PTR_ENABLE_LAYOUT_STATS
+#include <static_ptr/static_any.hpp>
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+struct base {
+  std::int32_t value;
+};
+struct small : base {
+};
+struct large : base {
+  std::int32_t more[5];
+};
+
+using small_layout = static_ptr::static_ptr_layout<base, 24, small>;
+using large_layout = static_ptr::static_ptr_layout<base, 24, large>;
+
+static_assert(small_layout::buffer_size == 24, "");
+static_assert(small_layout::op_size == sizeof(void*), "");
+static_assert(small_layout::size ==
+              sizeof(static_ptr::static_ptr<base, 24>), "");
+static_assert(small_layout::size ==
+              small_layout::buffer_size + small_layout::op_size +
+              small_layout::padding, "");
+static_assert(small_layout::object_size == 4, "");
+static_assert(small_layout::slack == 20, "");
+static_assert(small_layout::wasted == small_layout::size - 4, "");
+static_assert(large_layout::slack == 0, "");
+static_assert(large_layout::wasted ==
+              large_layout::op_size + large_layout::padding, "");
+
+// an 8-byte aligned buffer of 12 bytes is padded after the op table pointer
+// on 64-bit targets, and before it in other layouts
+using padded_layout = static_ptr::static_ptr_layout<base, 12, base, 8>;
+static_assert(padded_layout::size % 8 == 0, "");
+static_assert(padded_layout::padding ==
+              padded_layout::size - 12 - padded_layout::op_size, "");
+
+template <typename T, size_t S, size_t A = alignof(T)>
+static const static_ptr::layout_stats& stats()
+{
+  return static_ptr::_::layout_stats_for<T, S, A>::stats;
+}
+
+TEST(LayoutStats, Handles)
+{
+  using ptr = static_ptr::static_ptr<base, 24>;
+  const auto& s = stats<base, 24>();
+  ASSERT_EQ(24u, s.buffer_size());
+  ASSERT_EQ(sizeof(ptr), s.handle_size());
+  {
+    std::vector<ptr> handles(10);
+    ASSERT_EQ(10, s.handles());
+    ASSERT_EQ(0, s.objects());
+    ASSERT_EQ(10 * static_cast<long long>(sizeof(ptr)), s.reserved_bytes());
+    ASSERT_EQ(0, s.used_bytes());
+
+    handles[0].emplace<small>();
+    handles[1].emplace<large>();
+    ASSERT_EQ(2, s.objects());
+    ASSERT_EQ(static_cast<long long>(sizeof(small) + sizeof(large)),
+              s.used_bytes());
+
+    // moves transfer the object, copies add one
+    handles[2] = std::move(handles[1]);
+    ASSERT_EQ(2, s.objects());
+    ptr copy{handles[2]};
+    ASSERT_EQ(11, s.handles());
+    ASSERT_EQ(3, s.objects());
+    ASSERT_EQ(static_cast<long long>(sizeof(small) + 2 * sizeof(large)),
+              s.used_bytes());
+
+    handles[0].reset();
+    copy = handles[3];
+    ASSERT_EQ(1, s.objects());
+    ASSERT_EQ(static_cast<long long>(sizeof(large)), s.used_bytes());
+  }
+  ASSERT_EQ(0, s.handles());
+  ASSERT_EQ(0, s.objects());
+  ASSERT_EQ(0, s.used_bytes());
+}
+
+TEST(LayoutStats, Conversions)
+{
+  using small_ptr = static_ptr::static_ptr<base, 8>;
+  using big_ptr = static_ptr::static_ptr<base, 24>;
+  small_ptr p{static_ptr::in_place_t<small>{}};
+  big_ptr q{std::move(p)};
+  ASSERT_EQ(0, (stats<base, 8>().objects()));
+  ASSERT_EQ(1, (stats<base, 24>().objects()));
+}
+
+TEST(LayoutStats, StaticAny)
+{
+  using any = static_ptr::static_any<32>;
+  const auto& s = stats<static_ptr::_::any_value, 32,
+                        alignof(std::max_align_t)>();
+  any a{std::int64_t{1}};
+  any b{std::int16_t{2}};
+  ASSERT_EQ(2, s.handles());
+  ASSERT_EQ(10, s.used_bytes());
+  b = a;
+  ASSERT_EQ(16, s.used_bytes());
+}
+
+TEST(LayoutStats, Registry)
+{
+  static_ptr::static_ptr<base, 24> p{static_ptr::in_place_t<small>{}};
+  ASSERT_LE(static_cast<long long>(sizeof(p)),
+            static_ptr::layout_registry::reserved_bytes());
+  ASSERT_LE(static_cast<long long>(sizeof(small)),
+            static_ptr::layout_registry::used_bytes());
+
+  std::ostringstream out;
+  static_ptr::layout_registry::dump(out);
+  const auto text = out.str();
+  ASSERT_NE(std::string::npos, text.find(typeid(base).name()));
+  ASSERT_NE(std::string::npos, text.find("S=24"));
+  ASSERT_NE(std::string::npos, text.find("total: reserved="));
+}
@@ -0,0 +1,169 @@
+#include <static_ptr/static_ptr_vector.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+
+struct base {
+  virtual ~base() = default;
+  virtual int get() const { return 0; }
+};
+struct derived : base {
+  int value = 0;
+  derived() = default;
+  explicit derived(int value) : value(value) {}
+  int get() const override { return value; }
+};
+struct counted : base {
+  static int count;
+  counted() noexcept { ++count; }
+  counted(const counted&) noexcept { ++count; }
+  ~counted() { --count; }
+  int get() const override { return -1; }
+};
+int counted::count = 0;
+
+using base_vector = static_ptr::static_ptr_vector<base, sizeof(derived)>;
+
+struct pod { int i; };
+using pod_vector = static_ptr::static_ptr_vector<pod>;
+
+TEST(StaticPtrVector, EmplaceBack)
+{
+  base_vector v;
+  ASSERT_TRUE(v.empty());
+  for (int i = 0; i < 100; i++) {
+    if (i % 2) {
+      v.emplace_back<derived>(i);
+    } else {
+      v.emplace_back();
+    }
+  }
+  ASSERT_EQ(100u, v.size());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(i % 2 ? i : 0, v[i].get());
+  }
+  ASSERT_EQ(static_ptr::_::type_erasure_ops::get_operate<derived>(), v.type_of(1));
+  ASSERT_EQ(static_ptr::_::type_erasure_ops::get_operate<base>(), v.type_of(0));
+}
+
+TEST(StaticPtrVector, Iterate)
+{
+  base_vector v;
+  for (int i = 0; i < 10; i++) {
+    v.emplace_back<derived>(i);
+  }
+  int sum = 0;
+  for (const base& b : v) {
+    sum += b.get();
+  }
+  ASSERT_EQ(45, sum);
+  ASSERT_EQ(10, std::distance(v.begin(), v.end()));
+  ASSERT_EQ(9, (v.end() - 1)->get());
+  ASSERT_EQ(0, v.front().get());
+  ASSERT_EQ(9, v.back().get());
+  const base_vector& c = v;
+  ASSERT_EQ(9, std::max_element(c.begin(), c.end(),
+      [] (const base& l, const base& r) { return l.get() < r.get(); })->get());
+}
+
+TEST(StaticPtrVector, CacheLineAligned)
+{
+  base_vector v;
+  v.emplace_back();
+  ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(&v[0]) % 64);
+}
+
+TEST(StaticPtrVector, Destruct)
+{
+  counted::count = 0;
+  {
+    base_vector v;
+    for (int i = 0; i < 50; i++) {
+      v.emplace_back<counted>();
+    }
+    ASSERT_EQ(50, counted::count);
+    v.pop_back();
+    ASSERT_EQ(49, counted::count);
+    base_vector w{v};
+    ASSERT_EQ(98, counted::count);
+    w.clear();
+    ASSERT_EQ(49, counted::count);
+    w = std::move(v);
+    ASSERT_EQ(49, counted::count);
+    ASSERT_TRUE(v.empty());
+  }
+  ASSERT_EQ(0, counted::count);
+}
+
+TEST(StaticPtrVector, Copy)
+{
+  base_vector v;
+  v.emplace_back<derived>(1);
+  v.emplace_back<derived>(2);
+  base_vector w;
+  w = v;
+  ASSERT_EQ(2u, w.size());
+  ASSERT_EQ(2, w[1].get());
+  ASSERT_NE(&v[1], &w[1]);
+}
+
+TEST(StaticPtrVector, Trivial)
+{
+  pod_vector v;
+  for (int i = 0; i < 1000; i++) {
+    v.emplace_back(pod{i});
+  }
+  pod_vector w{v};
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(i, w[i].i);
+  }
+
+  // copies of an empty vector, whose arrays are null
+  pod_vector empty;
+  pod_vector x{empty};
+  ASSERT_TRUE(x.empty());
+  w = empty;
+  ASSERT_TRUE(w.empty());
+}
+
+struct no_copy {
+  no_copy() = default;
+  no_copy(no_copy&&) = default;
+  no_copy& operator=(no_copy&&) = default;
+};
+
+TEST(StaticPtrVector, NoCopy)
+{
+  using no_copy_vector = static_ptr::static_ptr_vector<no_copy>;
+  ASSERT_FALSE(std::is_copy_constructible<no_copy_vector>::value);
+  ASSERT_FALSE(std::is_copy_assignable<no_copy_vector>::value);
+  ASSERT_TRUE(std::is_nothrow_move_constructible<no_copy_vector>::value);
+  no_copy_vector v;
+  v.emplace_back();
+  no_copy_vector w{std::move(v)};
+  ASSERT_EQ(1u, w.size());
+}
+
+struct text {
+  std::string value;
+  explicit text(std::string value) : value(std::move(value)) {}
+  text(const text&) = default;
+  text(text&&) noexcept = default;
+  virtual ~text() = default;
+};
+
+TEST(StaticPtrVector, EmplaceBackOwnElement)
+{
+  // growing keeps the element that the argument refers to alive until the
+  // copy is made
+  static_ptr::static_ptr_vector<text> v;
+  v.emplace_back(std::string(32, 'x'));
+  while (v.size() < v.capacity()) {
+    v.emplace_back(std::string{"filler"});
+  }
+  const size_t cap = v.capacity();
+  v.emplace_back(v[0]);
+  ASSERT_LT(cap, v.capacity());
+  ASSERT_EQ(std::string(32, 'x'), v[0].value);
+  ASSERT_EQ(std::string(32, 'x'), v.back().value);
+}
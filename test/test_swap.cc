@@ -0,0 +1,188 @@
+#include <static_ptr/static_any.hpp>
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+// counts live objects to catch leaks and double destruction
+static int live = 0;
+
+struct base {
+  int value;
+  explicit base(int value) noexcept : value(value) { live++; }
+  base(const base& o) noexcept : value(o.value) { live++; }
+  base& operator=(const base& o) noexcept { value = o.value; return *this; }
+  virtual ~base() { live--; }
+  virtual int get() const { return value; }
+};
+struct derived : base {
+  int extra;
+  derived(int value, int extra) noexcept : base(value), extra(extra) {}
+  int get() const override { return value + extra; }
+};
+
+using ptr = static_ptr::static_ptr<base, sizeof(derived)>;
+
+TEST(Swap, Empty)
+{
+  ptr a, b;
+  swap(a, b);
+  ASSERT_FALSE(a);
+  ASSERT_FALSE(b);
+
+  live = 0;
+  {
+    auto c = ptr::make(1);
+    a.swap(c);
+    ASSERT_TRUE(a);
+    ASSERT_FALSE(c);
+    ASSERT_EQ(1, a->get());
+    c.swap(a);
+    ASSERT_FALSE(a);
+    ASSERT_EQ(1, c->get());
+    ASSERT_EQ(1, live);
+  }
+  ASSERT_EQ(0, live);
+}
+
+TEST(Swap, SameAndDifferentTypes)
+{
+  live = 0;
+  {
+    auto a = ptr::make(1);
+    auto b = ptr::make(2);
+    swap(a, b);
+    ASSERT_EQ(2, a->get());
+    ASSERT_EQ(1, b->get());
+
+    auto c = ptr::make<derived>(3, 4);
+    swap(a, c);
+    ASSERT_EQ(7, a->get());
+    ASSERT_EQ(2, c->get());
+    ASSERT_EQ(3, live);
+  }
+  ASSERT_EQ(0, live);
+}
+
+struct trivial {
+  int value;
+};
+struct trivial_derived : trivial {
+  int extra;
+  trivial_derived() = default;
+  trivial_derived(int value, int extra) : trivial{value}, extra(extra) {}
+};
+
+TEST(Swap, Trivial)
+{
+  using trivial_ptr = static_ptr::static_ptr<trivial, sizeof(trivial_derived)>;
+  static_assert(trivial_ptr::nothrow_swap, "");
+  trivial_ptr a{static_ptr::in_place_t<trivial>{}, trivial{1}};
+  trivial_ptr b{static_ptr::in_place_t<trivial_derived>{}, 2, 3};
+  trivial_ptr c;
+  swap(a, b);
+  ASSERT_EQ(2, a->value);
+  ASSERT_EQ(3, static_cast<trivial_derived*>(a.get())->extra);
+  ASSERT_EQ(1, b->value);
+  swap(b, c);
+  ASSERT_FALSE(b);
+  ASSERT_EQ(1, c->value);
+}
+
+// records a move construction of an object into its own storage
+static bool self_moved = false;
+struct self_checked {
+  self_checked() = default;
+  self_checked(self_checked&& o) noexcept { self_moved |= this == &o; }
+};
+
+// std::shuffle and others may swap an element with itself
+TEST(Swap, Self)
+{
+  live = 0;
+  {
+    auto a = ptr::make<derived>(3, 4);
+    swap(a, a);
+    ASSERT_EQ(7, a->get());
+    ASSERT_EQ(1, live);
+  }
+  ASSERT_EQ(0, live);
+
+  using trivial_ptr = static_ptr::static_ptr<trivial, sizeof(trivial_derived)>;
+  trivial_ptr b{static_ptr::in_place_t<trivial_derived>{}, 2, 3};
+  swap(b, b);
+  ASSERT_EQ(2, b->value);
+  ASSERT_EQ(3, static_cast<trivial_derived*>(b.get())->extra);
+
+  static_ptr::static_any<16> c{1};
+  swap(c, c);
+  ASSERT_EQ(1, static_ptr::any_cast<int>(c));
+
+  // nothing is relocated onto itself
+  self_moved = false;
+  auto d = static_ptr::static_ptr<self_checked>::make();
+  swap(d, d);
+  ASSERT_FALSE(self_moved);
+}
+
+// a type whose move constructor may throw is swapped through moves
+struct throwing {
+  int value;
+  explicit throwing(int value) : value(value) {}
+  throwing(throwing&& o) noexcept(false) : value(o.value) {}
+  throwing& operator=(throwing&& o) noexcept(false) {
+    value = o.value;
+    return *this;
+  }
+};
+
+TEST(Swap, ThrowingRelocation)
+{
+  using throwing_ptr = static_ptr::static_ptr<throwing>;
+  static_assert(!noexcept(std::declval<throwing_ptr&>().swap(
+                    std::declval<throwing_ptr&>())), "");
+  auto a = throwing_ptr::make(1);
+  auto b = throwing_ptr::make(2);
+  swap(a, b);
+  ASSERT_EQ(2, a->value);
+  ASSERT_EQ(1, b->value);
+}
+
+TEST(Swap, StaticAny)
+{
+  static_ptr::static_any<16> a{1}, b{2.5}, c;
+  swap(a, b);
+  ASSERT_EQ(2.5, static_ptr::any_cast<double>(a));
+  ASSERT_EQ(1, static_ptr::any_cast<int>(b));
+  a.swap(c);
+  ASSERT_FALSE(a.has_value());
+  ASSERT_EQ(2.5, static_ptr::any_cast<double>(c));
+}
+
+TEST(Swap, SortAndRotate)
+{
+  live = 0;
+  {
+    std::vector<ptr> v;
+    for (int i = 0; i < 100; i++) {
+      const int key = (i * 37) % 100;
+      if (i % 3) {
+        v.push_back(ptr::make(key));
+      } else {
+        v.push_back(ptr::make<derived>(key, 0));
+      }
+    }
+    std::sort(v.begin(), v.end(), [] (const ptr& l, const ptr& r) {
+      return l->get() < r->get();
+    });
+    for (int i = 0; i < 100; i++) {
+      ASSERT_EQ(i, v[i]->get());
+    }
+    std::rotate(v.begin(), v.begin() + 30, v.end());
+    for (int i = 0; i < 100; i++) {
+      ASSERT_EQ((i + 30) % 100, v[i]->get());
+    }
+    ASSERT_EQ(100, live);
+  }
+  ASSERT_EQ(0, live);
+}
@@ -0,0 +1,202 @@
+#include <static_ptr/static_thread_pool.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using pool_type = static_ptr::static_thread_pool<64>;
+using task = pool_type::task;
+using deque = static_ptr::_::work_stealing_deque<task>;
+
+TEST(WorkStealingDeque, OwnerIsLifoThiefIsFifo)
+{
+  deque d{4};
+  ASSERT_EQ(4u, d.capacity());
+  ASSERT_TRUE(d.empty());
+
+  int order[4] = {};
+  int next = 0;
+  for (int i = 0; i < 4; i++) {
+    task t{[&order, &next, i] { order[next++] = i; }};
+    ASSERT_TRUE(d.push(t));
+    ASSERT_FALSE(t);
+  }
+  task full{[] {}};
+  ASSERT_FALSE(d.push(full));
+  ASSERT_TRUE(full);
+
+  task t;
+  ASSERT_TRUE(d.steal(t));
+  t();
+  ASSERT_TRUE(d.pop(t));
+  t();
+  ASSERT_TRUE(d.steal(t));
+  t();
+  ASSERT_TRUE(d.pop(t));
+  t();
+  ASSERT_FALSE(d.pop(t));
+  ASSERT_FALSE(d.steal(t));
+  ASSERT_TRUE(d.empty());
+
+  ASSERT_EQ(0, order[0]);
+  ASSERT_EQ(3, order[1]);
+  ASSERT_EQ(1, order[2]);
+  ASSERT_EQ(2, order[3]);
+}
+
+TEST(WorkStealingDeque, Wraparound)
+{
+  deque d{2};
+  int sum = 0;
+  task t;
+  for (int i = 0; i < 100; i++) {
+    t = [&sum, i] { sum += i; };
+    ASSERT_TRUE(d.push(t));
+    if (i % 2) {
+      ASSERT_TRUE(d.steal(t));
+    } else {
+      ASSERT_TRUE(d.pop(t));
+    }
+    t();
+  }
+  ASSERT_EQ(4950, sum);
+}
+
+// the owner pushes and pops while thieves steal, and every task must run
+// exactly once
+TEST(WorkStealingDeque, Contention)
+{
+  constexpr int count = 100000;
+  constexpr int thieves = 4;
+  deque d{64};
+  std::unique_ptr<std::atomic<int>[]> runs{new std::atomic<int>[count]};
+  for (int i = 0; i < count; i++) {
+    runs[i].store(0);
+  }
+  std::atomic<int> done{0};
+  std::atomic<bool> finished{false};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thieves; i++) {
+    threads.emplace_back([&] {
+      task t;
+      while (!finished.load()) {
+        if (d.steal(t)) {
+          t();
+          t = nullptr;
+        }
+      }
+    });
+  }
+
+  task t;
+  for (int i = 0; i < count; i++) {
+    t = [&runs, &done, i] { runs[i]++; done++; };
+    while (!d.push(t)) {
+      task mine;
+      if (d.pop(mine)) {
+        mine();
+      }
+    }
+    if (i % 3 == 0 && d.pop(t)) {
+      t();
+    }
+  }
+  while (d.pop(t)) {
+    t();
+  }
+  while (done.load() != count) {
+    std::this_thread::yield();
+  }
+  finished = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < count; i++) {
+    ASSERT_EQ(1, runs[i].load()) << i;
+  }
+}
+
+TEST(StaticThreadPool, External)
+{
+  constexpr int count = 100000;
+  std::atomic<int> sum{0};
+  pool_type pool{4, 256};
+  ASSERT_EQ(4u, pool.size());
+  for (int i = 0; i < count; i++) {
+    pool.submit([&sum] { sum++; });
+  }
+  pool.wait();
+  ASSERT_EQ(count, sum.load());
+}
+
+// tasks submitted from tasks go to the worker's own deque and get stolen
+static void spawn(pool_type& pool, std::atomic<int>& leaves, int depth)
+{
+  if (depth == 0) {
+    leaves++;
+    return;
+  }
+  pool.submit([&pool, &leaves, depth] { spawn(pool, leaves, depth - 1); });
+  pool.submit([&pool, &leaves, depth] { spawn(pool, leaves, depth - 1); });
+}
+
+TEST(StaticThreadPool, Recursive)
+{
+  std::atomic<int> leaves{0};
+  pool_type pool{4, 16};
+  pool.submit([&pool, &leaves] { spawn(pool, leaves, 14); });
+  pool.wait();
+  ASSERT_EQ(1 << 14, leaves.load());
+}
+
+TEST(StaticThreadPool, ManySubmitters)
+{
+  constexpr int count = 20000;
+  constexpr int submitters = 4;
+  std::atomic<int> sum{0};
+  pool_type pool{4, 64};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < submitters; i++) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < count; j++) {
+        pool.submit([&sum] { sum++; });
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  pool.wait();
+  ASSERT_EQ(count * submitters, sum.load());
+}
+
+struct move_only_task {
+  std::unique_ptr<int> value;
+  std::atomic<int>* sum;
+  void operator()() { *sum += *value; }
+};
+
+TEST(StaticThreadPool, MoveOnlyTasks)
+{
+  std::atomic<int> sum{0};
+  pool_type pool{2};
+  for (int i = 0; i < 1000; i++) {
+    pool.submit(move_only_task{std::unique_ptr<int>{new int{i}}, &sum});
+  }
+  pool.wait();
+  ASSERT_EQ(499500, sum.load());
+}
+
+TEST(StaticThreadPool, DestructorDrains)
+{
+  std::atomic<int> sum{0};
+  {
+    pool_type pool{2, 4096};
+    for (int i = 0; i < 1000; i++) {
+      pool.submit([&sum] { sum++; });
+    }
+  }
+  ASSERT_EQ(1000, sum.load());
+}
@@ -0,0 +1,129 @@
+#include <static_ptr/static_ptr.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+template <typename T>
+using in_place_t = static_ptr::in_place_t<T>;
+
+// trivially copyable types take the memcpy fast path for everything
+struct pod {
+  int i;
+  double d;
+};
+struct derived_pod : pod {
+  int j;
+};
+
+using pod_ptr = static_ptr::static_ptr<pod, sizeof(derived_pod)>;
+
+// type that counts calls to its move constructor and destructor, but is
+// declared bitwise-relocatable so static_ptr never calls the move constructor
+struct relocatable {
+  static int moves;
+  static int destructs;
+  int* p;
+  explicit relocatable(int* p) : p(p) {}
+  relocatable(relocatable&& o) noexcept : p(o.p) { ++moves; o.p = nullptr; }
+  relocatable& operator=(relocatable&& o) noexcept {
+    ++moves;
+    p = o.p;
+    o.p = nullptr;
+    return *this;
+  }
+  ~relocatable() { ++destructs; }
+};
+int relocatable::moves = 0;
+int relocatable::destructs = 0;
+
+namespace static_ptr {
+template <> struct is_trivially_relocatable<relocatable> : std::true_type {};
+} // namespace static_ptr
+
+using relocatable_ptr = static_ptr::static_ptr<relocatable>;
+using string_ptr = static_ptr::static_ptr<std::string>;
+
+TEST(TrivialPtr, Traits)
+{
+  ASSERT_TRUE(pod_ptr::trivial_relocate);
+  ASSERT_TRUE(pod_ptr::trivial_copy);
+  ASSERT_TRUE(pod_ptr::trivial_destruct);
+  ASSERT_TRUE(relocatable_ptr::trivial_relocate);
+  ASSERT_FALSE(relocatable_ptr::trivial_copy);
+  ASSERT_FALSE(relocatable_ptr::trivial_destruct);
+  ASSERT_FALSE(string_ptr::trivial_relocate);
+  ASSERT_FALSE(string_ptr::trivial_copy);
+  ASSERT_FALSE(string_ptr::trivial_destruct);
+  ASSERT_TRUE(std::is_nothrow_move_constructible<pod_ptr>::value);
+  ASSERT_TRUE(std::is_nothrow_copy_constructible<pod_ptr>::value);
+}
+
+TEST(TrivialPtr, DerivedMustMatchBase)
+{
+  struct derived_string : pod { std::string s; };
+  static_assert(!static_ptr::_::supports_same_ops<pod, derived_string>::value,
+                "non-trivial derived type must be rejected");
+  static_assert(static_ptr::_::supports_same_ops<pod, derived_pod>::value,
+                "trivial derived type must be accepted");
+}
+
+TEST(TrivialPtr, MoveConstructible)
+{
+  pod_ptr a{in_place_t<derived_pod>{}};
+  a->i = 42;
+  a->d = 1.5;
+  static_cast<derived_pod&>(*a).j = 7;
+  pod_ptr b{std::move(a)};
+  ASSERT_FALSE(a);
+  ASSERT_TRUE(b);
+  ASSERT_EQ(42, b->i);
+  ASSERT_EQ(1.5, b->d);
+  ASSERT_EQ(7, static_cast<derived_pod&>(*b).j);
+}
+
+TEST(TrivialPtr, MoveAssignable)
+{
+  pod_ptr a{in_place_t<derived_pod>{}};
+  a->i = 42;
+  pod_ptr b{in_place_t<pod>{}};
+  b = std::move(a);
+  ASSERT_FALSE(a);
+  ASSERT_EQ(42, b->i);
+  b = pod_ptr{};
+  ASSERT_FALSE(b);
+}
+
+TEST(TrivialPtr, Copyable)
+{
+  pod_ptr a{in_place_t<derived_pod>{}};
+  a->i = 42;
+  pod_ptr b{a};
+  ASSERT_TRUE(a);
+  ASSERT_EQ(42, b->i);
+  pod_ptr c;
+  c = a;
+  ASSERT_EQ(42, c->i);
+  a.reset();
+  c = a;
+  ASSERT_FALSE(c);
+}
+
+TEST(TrivialPtr, RelocateSkipsMoveConstructor)
+{
+  relocatable::moves = 0;
+  relocatable::destructs = 0;
+  int value = 0;
+  {
+    relocatable_ptr a{in_place_t<relocatable>{}, &value};
+    relocatable_ptr b{std::move(a)};
+    ASSERT_FALSE(a);
+    ASSERT_EQ(&value, b->p);
+    relocatable_ptr c;
+    c = std::move(b);
+    ASSERT_FALSE(b);
+    ASSERT_EQ(&value, c->p);
+    ASSERT_EQ(0, relocatable::moves);
+    ASSERT_EQ(0, relocatable::destructs);
+  }
+  // only the one live object was destroyed
+  ASSERT_EQ(1, relocatable::destructs);
+}